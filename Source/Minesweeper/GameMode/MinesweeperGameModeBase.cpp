@@ -6,6 +6,7 @@
 #include "Engine/Engine.h"
 #include "Minesweeper/Player/MinesweeperPlayerControllerBase.h"
 #include "MinesweeperGameStateBase.h"
+#include "Minesweeper/Includes/MineGridRect.h"
 
 const FIntPoint AMinesweeperGameModeBase::DefaultCellCoords(-1, -1);
 
@@ -14,6 +15,12 @@ AMinesweeperGameModeBase::AMinesweeperGameModeBase(): Super()
 	// Setting defaults
 	MineGridMapVersion = 0;
 	bIsGameOver = false;
+	MaxDenseMapCellCount = 1 << 24;
+	MineGridMapJournalCapacity = 4096;
+	bHasChangedCells = false;
+	DefaultMineDensity = 1.0f / 6.0f;
+	bIsFirstTriggerSafe = false;
+	bIsFirstTriggerPending = false;
 }
 
 void AMinesweeperGameModeBase::BeginPlay()
@@ -43,10 +50,107 @@ void AMinesweeperGameModeBase::PostLogin(APlayerController* NewPlayer)
 	}
 }
 
+void AMinesweeperGameModeBase::SetPlayerViewBounds(AMinesweeperPlayerControllerBase* Player, const FIntRect& ViewBounds)
+{
+	const FIntRect ViewTileBounds = GetViewTileBounds(ViewBounds);
+
+	// Move player between tiles only as view crosses tile borders
+	if (FIntRect* PrevViewBounds = PlayerViewBounds.Find(Player))
+	{
+		const FIntRect PrevViewTileBounds = GetViewTileBounds(*PrevViewBounds);
+		if (PrevViewTileBounds != ViewTileBounds)
+		{
+			RemovePlayerViewTiles(Player, PrevViewTileBounds);
+			AddPlayerViewTiles(Player, ViewTileBounds);
+		}
+		*PrevViewBounds = ViewBounds;
+	}
+	else
+	{
+		PlayerViewBounds.Add(Player, ViewBounds);
+		AddPlayerViewTiles(Player, ViewTileBounds);
+	}
+
+	// Mines of chunked map are revealed only where they can be seen, so areas coming into view after game over reveal theirs.
+	// Player moving its area reads revealed mines along with cells entering it, so it is not notified halfway through.
+	if (bIsGameOver && MineGridMap.IsChunked())
+	{
+		RevealMinesInBounds(ViewBounds, Player);
+	}
+}
+
+void AMinesweeperGameModeBase::RemovePlayerView(AMinesweeperPlayerControllerBase* Player)
+{
+	FIntRect ViewBounds;
+	if (PlayerViewBounds.RemoveAndCopyValue(Player, ViewBounds))
+	{
+		RemovePlayerViewTiles(Player, GetViewTileBounds(ViewBounds));
+	}
+}
+
+FIntRect AMinesweeperGameModeBase::GetViewTileBounds(const FIntRect& ViewBounds)
+{
+	// Empty view covers no tile, keeping its end below its start
+	if (MineGridRect::IsEmpty(ViewBounds))
+	{
+		return FIntRect(FIntPoint::ZeroValue, FIntPoint(-1, -1));
+	}
+	return FIntRect(
+		FIntPoint(ViewBounds.Min.X >> FMineGridMap::TileSizeLog2, ViewBounds.Min.Y >> FMineGridMap::TileSizeLog2),
+		FIntPoint(ViewBounds.Max.X >> FMineGridMap::TileSizeLog2, ViewBounds.Max.Y >> FMineGridMap::TileSizeLog2)
+	);
+}
+
+void AMinesweeperGameModeBase::AddPlayerViewTiles(AMinesweeperPlayerControllerBase* Player, const FIntRect& ViewTileBounds)
+{
+	for (int32 Y = ViewTileBounds.Min.Y; Y <= ViewTileBounds.Max.Y; Y++)
+	{
+		for (int32 X = ViewTileBounds.Min.X; X <= ViewTileBounds.Max.X; X++)
+		{
+			PlayerViewTiles.FindOrAdd(FIntPoint(X, Y)).Add(Player);
+		}
+	}
+}
+
+void AMinesweeperGameModeBase::RemovePlayerViewTiles(AMinesweeperPlayerControllerBase* Player, const FIntRect& ViewTileBounds)
+{
+	for (int32 Y = ViewTileBounds.Min.Y; Y <= ViewTileBounds.Max.Y; Y++)
+	{
+		for (int32 X = ViewTileBounds.Min.X; X <= ViewTileBounds.Max.X; X++)
+		{
+			const FIntPoint TileCoords(X, Y);
+			if (TArray<AMinesweeperPlayerControllerBase*>* TilePlayers = PlayerViewTiles.Find(TileCoords))
+			{
+				TilePlayers->RemoveSingleSwap(Player);
+				if (TilePlayers->Num() == 0)
+				{
+					PlayerViewTiles.Remove(TileCoords);
+				}
+			}
+		}
+	}
+}
+
+TMap<FIntPoint, EMineGridMapCell> AMinesweeperGameModeBase::GetMineGridMapCells() const
+{
+	TMap<FIntPoint, EMineGridMapCell> CellsView;
+	MineGridMap.ExportCells(CellsView);
+
+	return CellsView;
+}
+
 void AMinesweeperGameModeBase::HandleOnPlayerTriggeredCoords(const FIntPoint& EnteredCoords)
 {
-	if (!bIsGameOver && RemainingClearCellCount > 0)
+	if (!bIsGameOver && RemainingClearCellCount > 0 && MineGridMap.IsValidCoords(EnteredCoords))
 	{
+		if (bIsFirstTriggerPending)
+		{
+			// Clear mines around first triggered cell before anything relies on layout
+			bIsFirstTriggerPending = false;
+			MineLayer.SetSafeBounds(FIntRect(EnteredCoords - 1, EnteredCoords + 1));
+			PrepareMineLayer();
+		}
+
 		OpenCell(EnteredCoords);
 
 		if (RemainingClearCellCount == 0)
@@ -62,16 +166,32 @@ void AMinesweeperGameModeBase::HandleOnPlayerTriggeredCoords(const FIntPoint& En
 	}
 }
 
+void AMinesweeperGameModeBase::PrepareMineLayer()
+{
+	// Mines of chunked maps stay with generator, counted around cells as they get opened by scanline fill only
+	if (MineGridMap.IsDense())
+	{
+		// Count surrounding mines of every cell at once, so opening cells only reads them
+		MineLayer.Materialize();
+		MineLayer.ComputeAdjacentMineCounts();
+
+		// Label areas opened at once, so stepping into them only copies their cells
+		ZeroRegionIndex.Build(MineLayer);
+	}
+
+	RemainingClearCellCount = MineGridMap.Num() - MineLayer.NumMines;
+}
+
 void AMinesweeperGameModeBase::OpenCell(const FIntPoint& EnteredCoords)
 {
-	if (ActualMinesHidden.Contains(EnteredCoords))
+	bHasChangedCells = false;
+
+	if (MineLayer.IsMine(EnteredCoords))
 	{
-		// Assign revealed state of cells containg all remaining mines and set opening cell exploded
-		for (FIntPoint HiddenMineCoords : ActualMinesHidden)
-		{
-			MineGridMap.Cells.Emplace(HiddenMineCoords, EMineGridMapCell::MGMC_Revealed);
-		}
-		MineGridMap.Cells.Emplace(EnteredCoords, EMineGridMapCell::MGMC_Exploded);
+		// Set opening cell exploded and assign revealed state of cells containg all remaining mines,
+		// so that journal holds only final value of every cell
+		SetMineGridMapCell(EnteredCoords, EMineGridMapCell::MGMC_Exploded);
+		RevealMines();
 
 		bIsGameOver = true;
 
@@ -85,84 +205,295 @@ void AMinesweeperGameModeBase::OpenCell(const FIntPoint& EnteredCoords)
 	}
 	else
 	{
-		// 
-		// Use of queue to automatically open nearby cells if opened cell with no mines around it
-		//
+		OpenClearCells(EnteredCoords);
+	}
+
+	MineGridMapVersion += 1;
+	NotifyPlayersOfChangedCells();
+
+	if (AMinesweeperGameStateBase* MinesweeperGameState = GetGameState<AMinesweeperGameStateBase>())
+	{
+		MinesweeperGameState->SetNumUndiscoveredClearCells(RemainingClearCellCount);
+	}
+}
 
-		TQueue<FIntPoint> RemainingCells;
-		RemainingCells.Enqueue(EnteredCoords);
+void AMinesweeperGameModeBase::SetMineGridMapCell(const FIntPoint& CellCoords, const EMineGridMapCell CellValue)
+{
+	MineGridMap.SetCell(CellCoords, CellValue);
+	RecordCellChange(CellCoords, CellValue);
+}
+
+void AMinesweeperGameModeBase::RecordCellChange(const FIntPoint& CellCoords, const EMineGridMapCell CellValue)
+{
+	// Changes made while opening cell belong to version following current one
+	MineGridMapJournal.Append(MineGridMapVersion + 1, CellCoords, CellValue);
 
-		FIntPoint RemainingCellCoords;
+	if (bHasChangedCells)
+	{
+		ChangedCellBounds.Min = ChangedCellBounds.Min.ComponentMin(CellCoords);
+		ChangedCellBounds.Max = ChangedCellBounds.Max.ComponentMax(CellCoords);
+	}
+	else
+	{
+		ChangedCellBounds = FIntRect(CellCoords, CellCoords);
+		bHasChangedCells = true;
+	}
+}
 
-		TArray<FIntPoint> SurroundingCellCoordsList;
-		SurroundingCellCoordsList.Reserve(8);
-		while (RemainingCells.Dequeue(RemainingCellCoords))
+void AMinesweeperGameModeBase::NotifyPlayersOfChangedCells(AMinesweeperPlayerControllerBase* SkippedPlayer)
+{
+	if (!bHasChangedCells)
+	{
+		return;
+	}
+
+	// Players not seeing any of changed cells fall behind, catching up once they see later changes
+	const FIntRect ChangedTileBounds = GetViewTileBounds(ChangedCellBounds);
+
+	// Changes spanning more tiles than there are players are checked against every player instead
+	if (MineGridRect::NumCells(ChangedTileBounds) > PlayerViewBounds.Num())
+	{
+		for (const TPair<AMinesweeperPlayerControllerBase*, FIntRect>& PlayerView : PlayerViewBounds)
 		{
-			// Skip if cell is already opened
-			if (MineGridMap.Cells[RemainingCellCoords] != EMineGridMapCell::MGMC_Undiscovered)
+			if (PlayerView.Key != SkippedPlayer && MineGridRect::Intersects(PlayerView.Value, ChangedCellBounds) && IsValid(PlayerView.Key))
 			{
-				continue;
+				PlayerView.Key->HandleOnMineGridMapUpdated(MineGridMapVersion);
 			}
+		}
+		return;
+	}
 
-			// Determine bounds of surrounding cells
-			FIntPoint StartValidSurroundingCoords(FMath::Clamp(RemainingCellCoords.X - 1, MineGridMap.StartCoords.X, MineGridMap.EndCoords.X),
-				FMath::Clamp(RemainingCellCoords.Y - 1, MineGridMap.StartCoords.Y, MineGridMap.EndCoords.Y));
-			FIntPoint EndValidSurroundingCoords(FMath::Clamp(RemainingCellCoords.X + 1, MineGridMap.StartCoords.X, MineGridMap.EndCoords.X),
-				FMath::Clamp(RemainingCellCoords.Y + 1, MineGridMap.StartCoords.Y, MineGridMap.EndCoords.Y));
+	// Player seeing several of changed tiles is notified once
+	TArray<AMinesweeperPlayerControllerBase*, TInlineAllocator<8>> NotifiedPlayers;
 
-			SurroundingCellCoordsList.Reset();
-			uint8 MinesCount = 0;
+	for (int32 Y = ChangedTileBounds.Min.Y; Y <= ChangedTileBounds.Max.Y; Y++)
+	{
+		for (int32 X = ChangedTileBounds.Min.X; X <= ChangedTileBounds.Max.X; X++)
+		{
+			const TArray<AMinesweeperPlayerControllerBase*>* TilePlayers = PlayerViewTiles.Find(FIntPoint(X, Y));
+			if (!TilePlayers)
+			{
+				continue;
+			}
 
-			// Iterate through every surrounding cell to count mines
-			for (int32 Y = StartValidSurroundingCoords.Y; Y <= EndValidSurroundingCoords.Y; Y++)
+			for (AMinesweeperPlayerControllerBase* Player : *TilePlayers)
 			{
-				for (int32 X = StartValidSurroundingCoords.X; X <= EndValidSurroundingCoords.X; X++)
+				if (Player != SkippedPlayer && !NotifiedPlayers.Contains(Player) && MineGridRect::Intersects(PlayerViewBounds.FindChecked(Player), ChangedCellBounds))
 				{
-					FIntPoint CellCoords(X, Y);
-
-					if (CellCoords == RemainingCellCoords)
+					NotifiedPlayers.Add(Player);
+					if (IsValid(Player))
 					{
-						continue;
+						Player->HandleOnMineGridMapUpdated(MineGridMapVersion);
 					}
+				}
+			}
+		}
+	}
+}
 
-					if (ActualMinesHidden.Contains(CellCoords))
-					{
-						MinesCount++;
-					}
+void AMinesweeperGameModeBase::RevealMines()
+{
+	// Exploded mine is skipped, keeping its value
+	auto RevealMine = [this](const FIntPoint& HiddenMineCoords)
+	{
+		if (MineGridMap.GetCell(HiddenMineCoords) == EMineGridMapCell::MGMC_Undiscovered)
+		{
+			SetMineGridMapCell(HiddenMineCoords, EMineGridMapCell::MGMC_Revealed);
+		}
+	};
 
-					SurroundingCellCoordsList.Add(CellCoords);
-				}
+	if (!MineGridMap.IsChunked())
+	{
+		MineLayer.ForEachMine(RevealMine);
+		return;
+	}
+
+	// Mines of chunked map are revealed only where they can be seen: in discovered tiles and in areas of players.
+	// Tiles having every cell discovered already contain no hidden mines. Areas seen later reveal theirs as players move.
+	TArray<FIntRect> RevealedBounds;
+
+	for (const TPair<FIntPoint, int32>& TileSlot : MineGridMap.TileSlots)
+	{
+		if (MineGridMap.GetTileSummary(TileSlot.Key) != EMineGridMapTileSummary::MGMTS_AllDiscovered)
+		{
+			const FIntPoint TileStartCoords = MineGridMap.StartCoords + TileSlot.Key * FMineGridMap::TileSize;
+			RevealedBounds.Emplace(TileStartCoords, TileStartCoords + (FMineGridMap::TileSize - 1));
+		}
+	}
+
+	for (FConstPlayerControllerIterator PlayerIt = GetWorld()->GetPlayerControllerIterator(); PlayerIt; ++PlayerIt)
+	{
+		if (auto MinesweeperPlayer = Cast<AMinesweeperPlayerControllerBase>(*PlayerIt))
+		{
+			const FMineGridMap& PlayerMapArea = MinesweeperPlayer->GetMineGridMapArea();
+			RevealedBounds.Emplace(PlayerMapArea.StartCoords, PlayerMapArea.EndCoords);
+		}
+	}
+
+	for (const FIntRect& Bounds : RevealedBounds)
+	{
+		MineLayer.ForEachMineInRect(Bounds, RevealMine);
+	}
+}
+
+void AMinesweeperGameModeBase::RevealMinesInBounds(const FIntRect& Bounds, AMinesweeperPlayerControllerBase* SkippedPlayer)
+{
+	bHasChangedCells = false;
+
+	MineLayer.ForEachMineInRect(Bounds, [this](const FIntPoint& HiddenMineCoords)
+	{
+		if (MineGridMap.GetCell(HiddenMineCoords) == EMineGridMapCell::MGMC_Undiscovered)
+		{
+			SetMineGridMapCell(HiddenMineCoords, EMineGridMapCell::MGMC_Revealed);
+		}
+	});
+
+	if (bHasChangedCells)
+	{
+		MineGridMapVersion += 1;
+		NotifyPlayersOfChangedCells(SkippedPlayer);
+	}
+}
+
+void AMinesweeperGameModeBase::OpenClearCells(const FIntPoint& EnteredCoords)
+{
+	// Skip if cell is already opened
+	if (MineGridMap.GetCell(EnteredCoords) != EMineGridMapCell::MGMC_Undiscovered)
+	{
+		return;
+	}
+
+	// Open only entered cell if it has mines around it
+	if (MineLayer.GetAdjacentMineCount(EnteredCoords) > 0)
+	{
+		OpenClearCell(EnteredCoords);
+		return;
+	}
+
+	// Open whole precomputed region of cells with no mines around along with its border
+	if (ZeroRegionIndex.IsBuilt())
+	{
+		const int32 EnteredIndex = MineGridMap.GetCellIndex(EnteredCoords);
+		for (const int32 RegionCellIndex : ZeroRegionIndex.GetRegionCells(ZeroRegionIndex.GetRegionAt(EnteredIndex)))
+		{
+			OpenClearCellAt(RegionCellIndex);
+		}
+		return;
+	}
+
+	// 
+	// Otherwise use of scanline fill to automatically open area of cells with no mines around them. Every span of such cells 
+	// in a row is opened along with its bordering cells, while runs of such cells in neighbouring rows become seeds of next spans.
+	// Every cell of processed span gets opened, so opened state of cells keeps them from being examined again.
+	//
+
+	const FIntPoint& StartCoords = MineGridMap.StartCoords;
+	const FIntPoint& EndCoords = MineGridMap.EndCoords;
+
+	auto IsZeroCellToFill = [this](const FIntPoint& CellCoords)
+	{
+		return MineLayer.GetAdjacentMineCount(CellCoords) == 0
+			&& MineGridMap.GetCell(CellCoords) == EMineGridMapCell::MGMC_Undiscovered;
+	};
+
+	FillSeeds.Reset();
+	FillSeeds.Push(EnteredCoords);
+
+	while (FillSeeds.Num() > 0)
+	{
+		const FIntPoint Seed = FillSeeds.Pop(false);
+		const int32 Row = Seed.Y;
+
+		// Skip if seed already became part of other span
+		if (MineGridMap.GetCell(Seed) != EMineGridMapCell::MGMC_Undiscovered)
+		{
+			continue;
+		}
+
+		// Extend span to the left and to the right
+		int32 Left = Seed.X;
+		int32 Right = Seed.X;
+		while (Left > StartCoords.X && IsZeroCellToFill(FIntPoint(Left - 1, Row)))
+		{
+			Left--;
+		}
+		while (Right < EndCoords.X && IsZeroCellToFill(FIntPoint(Right + 1, Row)))
+		{
+			Right++;
+		}
+
+		// Open span together with its bordering cells in the same row
+		const int32 BorderLeft = FMath::Max(Left - 1, StartCoords.X);
+		const int32 BorderRight = FMath::Min(Right + 1, EndCoords.X);
+
+		for (int32 Column = BorderLeft; Column <= BorderRight; Column++)
+		{
+			OpenClearCell(FIntPoint(Column, Row));
+		}
+
+		// Open bordering cells of rows above and below, seeding runs of cells with no mines around them
+		const int32 NeighbourRows[] = { Row - 1, Row + 1 };
+		for (const int32 NeighbourRow : NeighbourRows)
+		{
+			if (NeighbourRow < StartCoords.Y || NeighbourRow > EndCoords.Y)
+			{
+				continue;
 			}
 
-			// Assign number of mines to cell value and decrement number of clear cells
-			MineGridMap.Cells.Emplace(RemainingCellCoords, (EMineGridMapCell)MinesCount);
-			RemainingClearCellCount -= 1;
+			bool bIsPrevZeroCell = false;
 
-			// Add every surround cell if processed cell shows zero mines number
-			if (MinesCount == 0)
+			for (int32 Column = BorderLeft; Column <= BorderRight; Column++)
 			{
-				for (FIntPoint SurroundingCellCoords : SurroundingCellCoordsList)
+				const FIntPoint CellCoords(Column, NeighbourRow);
+				const bool bIsZeroCell = IsZeroCellToFill(CellCoords);
+
+				if (bIsZeroCell)
 				{
-					RemainingCells.Enqueue(SurroundingCellCoords);
+					if (!bIsPrevZeroCell)
+					{
+						FillSeeds.Push(CellCoords);
+					}
 				}
+				else
+				{
+					OpenClearCell(CellCoords);
+				}
+
+				bIsPrevZeroCell = bIsZeroCell;
 			}
 		}
 	}
+}
 
-	MineGridMapVersion += 1;
+void AMinesweeperGameModeBase::OpenClearCell(const FIntPoint& CellCoords)
+{
+	if (MineGridMap.GetCell(CellCoords) == EMineGridMapCell::MGMC_Undiscovered)
+	{
+		// Assign number of mines to cell value and decrement number of clear cells
+		SetMineGridMapCell(CellCoords, (EMineGridMapCell)MineLayer.GetAdjacentMineCount(CellCoords));
+		RemainingClearCellCount -= 1;
+	}
+}
 
-	if (AMinesweeperGameStateBase* MinesweeperGameState = GetGameState<AMinesweeperGameStateBase>())
+void AMinesweeperGameModeBase::OpenClearCellAt(const int32 CellIndex)
+{
+	if (MineGridMap.GetCellAt(CellIndex) == EMineGridMapCell::MGMC_Undiscovered)
 	{
-		MinesweeperGameState->SetNumUndiscoveredClearCells(RemainingClearCellCount);
+		// Assign number of mines to cell value and decrement number of clear cells
+		const EMineGridMapCell CellValue = (EMineGridMapCell)MineLayer.GetAdjacentMineCountAt(CellIndex);
+		MineGridMap.SetCellAt(CellIndex, CellValue);
+		RecordCellChange(MineGridMap.GetCellCoords(CellIndex), CellValue);
+		RemainingClearCellCount -= 1;
 	}
 }
 
-void AMinesweeperGameModeBase::HandleOnPlayerNewGame(const uint8 MapSize)
+void AMinesweeperGameModeBase::HandleOnPlayerNewGame(const uint8 MapSize, const int32 Seed, const float MineDensity)
 {
 	bIsGameOver = false;
 
-	GenerateNewMap(MapSize);
+	GenerateNewMap(MapSize, Seed, MineDensity);
 	MineGridMapVersion = 0;
+	MineGridMapJournal.Reset(MineGridMapVersion, MineGridMapJournalCapacity);
 
 	for (FConstPlayerControllerIterator PlayerIt = GetWorld()->GetPlayerControllerIterator(); PlayerIt; ++PlayerIt)
 	{
@@ -172,39 +503,68 @@ void AMinesweeperGameModeBase::HandleOnPlayerNewGame(const uint8 MapSize)
 			MinesweeperPlayer->AddRemoveGridMapAreaCells(MineGridMap, true);
 			MinesweeperPlayer->UpdateGridMapAreaCellValues(MineGridMap);
 
+			// Values were just read from new map, whose journal holds nothing to replay
+			MinesweeperPlayer->SetGridMapAreaVersion(MineGridMapVersion);
+
 			// Notify clients that game is started
 			MinesweeperPlayer->NotifyGameStarted();
 		}
 	}
 }
 
-void AMinesweeperGameModeBase::GenerateNewMap(const uint8 MapSize)
+void AMinesweeperGameModeBase::GenerateNewMap(const uint8 MapSize, const int32 Seed, const float MineDensity)
 {
-	FIntPoint BaseDimensions(5, 4);
-	int32 Scale = FMath::FloorToInt(FMath::Exp2(MapSize));
+	// Largest map size keeping number of cells within int32
+	const uint8 MaxMapSize = 13;
 
-	MineGridMap.GridDimensions = BaseDimensions * Scale;
-	MineGridMap.Cells.Empty(MineGridMap.GridDimensions.X * MineGridMap.GridDimensions.Y);
+	FIntPoint BaseDimensions(5, 4);
+	int32 Scale = FMath::FloorToInt(FMath::Exp2(FMath::Min(MapSize, MaxMapSize)));
 
-	MineGridMap.StartCoords = FIntPoint::ZeroValue;
-	MineGridMap.EndCoords = MineGridMap.GridDimensions - 1;
+	const FIntPoint GridDimensions = BaseDimensions * Scale;
+	const bool bIsDenseMap = GridDimensions.X * GridDimensions.Y <= MaxDenseMapCellCount;
 
-	ActualMinesHidden.Reset();
-	for (int32 Y = MineGridMap.StartCoords.Y; Y <= MineGridMap.EndCoords.Y; Y++)
+	if (bIsDenseMap)
 	{
-		for (int32 X = MineGridMap.StartCoords.X; X <= MineGridMap.EndCoords.X; X++)
-		{
-			FIntPoint CellCoords(X, Y);
-			MineGridMap.Cells.Emplace(CellCoords, EMineGridMapCell::MGMC_Undiscovered);
+		// Every cell starts undiscovered, held densely to keep memory low on large maps
+		MineGridMap.InitDense(GridDimensions, EMineGridMapCell::MGMC_Undiscovered);
+	}
+	else
+	{
+		// Cells of too large maps are held in tiles allocated as players discover them
+		MineGridMap.InitChunked(GridDimensions);
+	}
 
-			if (FMath::RandRange(0, 5) == 0)
-			{
-				ActualMinesHidden.Emplace(CellCoords);
-			}
-		}
+	// Random seed is logged, so that map can be reproduced
+	int32 MapSeed = Seed;
+	while (MapSeed == 0)
+	{
+		MapSeed = FMath::Rand();
+	}
+	if (Seed == 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("Generating map of size %d with seed %d."), MapSize, MapSeed);
 	}
 
-	RemainingClearCellCount = MineGridMap.Cells.Num() - ActualMinesHidden.Num();
+	// Mines are derived from seed on demand, with given share of cells mined rounded to whole mines
+	const float MapMineDensity = MineDensity > 0.0f ? FMath::Min(MineDensity, 1.0f) : DefaultMineDensity;
+	const int32 NumMines = (int32)FMath::RoundToDouble((double)MineGridMap.Num() * MapMineDensity);
+
+	FMineGridMineGenerator MineGenerator;
+	MineGenerator.Init(MineGridMap.GridDimensions, MapSeed, NumMines);
+	MineLayer.InitProcedural(MineGenerator);
+
+	ZeroRegionIndex.Reset();
+
+	// Safe layout is only known once first cell is triggered
+	bIsFirstTriggerPending = bIsFirstTriggerSafe;
+	if (!bIsFirstTriggerPending)
+	{
+		PrepareMineLayer();
+	}
+	else
+	{
+		RemainingClearCellCount = MineGridMap.Num() - MineLayer.NumMines;
+	}
 
 	if (AMinesweeperGameStateBase* MinesweeperGameState = GetGameState<AMinesweeperGameStateBase>())
 	{
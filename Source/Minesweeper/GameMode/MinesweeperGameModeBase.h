@@ -6,6 +6,9 @@
 #include "GameFramework/GameModeBase.h"
 
 #include "Minesweeper/Includes/MineGridMap.h"
+#include "Minesweeper/Includes/MineGridMapJournal.h"
+#include "Minesweeper/Includes/MineGridMineLayer.h"
+#include "Minesweeper/Includes/MineGridZeroRegionIndex.h"
 #include "Minesweeper/MineGrid/MineGridBase.h"
 
 #include "MinesweeperGameModeBase.generated.h"
@@ -28,10 +31,34 @@ public:
 
 	FORCEINLINE const int32 GetMineGridMapVersion() { return MineGridMapVersion; }
 
+	FORCEINLINE const FMineGridMapJournal& GetMineGridMapJournal() const { return MineGridMapJournal; }
+
+	/**
+	 * Sets bounds (end-inclusive) of grid map area seen by player, grid map updates being sent only to players seeing them.
+	 * Reveals mines coming into view of chunked map after game over, so it is to be set before cells of area are read.
+	 * Given player is not sent version revealing them, as it is in the middle of moving its area, catching up once it is done.
+	 */
+	void SetPlayerViewBounds(class AMinesweeperPlayerControllerBase* Player, const FIntRect& ViewBounds);
+
+	void RemovePlayerView(class AMinesweeperPlayerControllerBase* Player);
+
+	/** Builds coords to value view of current grid map, as map itself holds cells densely */
+	UFUNCTION(BlueprintPure, Category = "Minesweeper")
+	TMap<FIntPoint, EMineGridMapCell> GetMineGridMapCells() const;
+
 protected:
 
+	/**
+	 * Layout of hidden mines along with precomputed number of surrounding mines of every cell
+	 */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Minesweeper")
-	TSet<FIntPoint> ActualMinesHidden;
+	FMineGridMineLayer MineLayer;
+
+	/**
+	 * Precomputed areas of cells with no mines around, opened all at once when stepped into
+	 */
+	UPROPERTY()
+	FMineGridZeroRegionIndex ZeroRegionIndex;
 
 	/**
 	 * Current version of mine grid map
@@ -45,6 +72,27 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Minesweeper")
 	int32 MineGridMapVersion;
 
+	/**
+	 * Latest cell changes tagged with versions they belong to, so players catch up on them only
+	 */
+	UPROPERTY()
+	FMineGridMapJournal MineGridMapJournal;
+
+	/** Bounds (end-inclusive) of grid map areas seen by players, removed as players end play */
+	TMap<class AMinesweeperPlayerControllerBase*, FIntRect> PlayerViewBounds;
+
+	/** Players seeing every tile of grid map, tiles being sized as ones of chunked map. Tiles seen by nobody are not held. */
+	TMap<FIntPoint, TArray<class AMinesweeperPlayerControllerBase*>> PlayerViewTiles;
+
+	/** Bounds (end-inclusive) of cells changed by currently opening cell */
+	FIntRect ChangedCellBounds;
+
+	bool bHasChangedCells;
+
+	/** Least number of latest cell changes to be held by journal */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Minesweeper")
+	int32 MineGridMapJournalCapacity;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Minesweeper")
 	class AMinesweeperPlayerControllerBase* LobbyLeader;
 
@@ -57,6 +105,27 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Minesweeper")
 	bool bIsGameOver;
 
+	/** Reusable stack of scanline fill seeds */
+	TArray<FIntPoint> FillSeeds;
+
+	/**
+	 * Largest number of cells of map to be held densely. Larger maps hold cells in tiles allocated on discovery,
+	 * without precomputed surrounding mines.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Minesweeper")
+	int32 MaxDenseMapCellCount;
+
+	/** Share of mined cells of games started without one */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Minesweeper", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float DefaultMineDensity;
+
+	/** Whether cells around first triggered cell of every game are kept free of mines */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Minesweeper")
+	bool bIsFirstTriggerSafe;
+
+	/** Set while mines layout of current game waits for its first triggered cell */
+	bool bIsFirstTriggerPending;
+
 	virtual void BeginPlay() override;
 
 	virtual void PostLogin(APlayerController* NewPlayer) override;
@@ -64,8 +133,39 @@ protected:
 	UFUNCTION()
 	virtual void HandleOnPlayerTriggeredCoords(const FIntPoint& EnteredCoords);
 	UFUNCTION()
-	virtual void HandleOnPlayerNewGame(const uint8 MapSize);
+	virtual void HandleOnPlayerNewGame(const uint8 MapSize, const int32 Seed, const float MineDensity);
 
-	virtual void GenerateNewMap(const uint8 MapSize);
+	/** Generates map of given size with mines layout of given seed and density, defaults being used if not positive */
+	virtual void GenerateNewMap(const uint8 MapSize, const int32 Seed, const float MineDensity);
 	virtual void OpenCell(const FIntPoint& EnteredCoords);
+
+	/** Sets value of grid map cell, recording change in journal */
+	void SetMineGridMapCell(const FIntPoint& CellCoords, const EMineGridMapCell CellValue);
+
+	/** Records change of grid map cell in journal and bounds of changed cells */
+	void RecordCellChange(const FIntPoint& CellCoords, const EMineGridMapCell CellValue);
+
+	/** Sends new version of grid map to players seeing changed cells, looked up by tiles they span, except of given player */
+	void NotifyPlayersOfChangedCells(class AMinesweeperPlayerControllerBase* SkippedPlayer = nullptr);
+
+	/** Bounds (end-inclusive) of tiles covered by view bounds */
+	static FIntRect GetViewTileBounds(const FIntRect& ViewBounds);
+
+	void AddPlayerViewTiles(class AMinesweeperPlayerControllerBase* Player, const FIntRect& ViewTileBounds);
+	void RemovePlayerViewTiles(class AMinesweeperPlayerControllerBase* Player, const FIntRect& ViewTileBounds);
+
+	/** Materializes mines layout of dense map and precomputes what opening its cells relies on */
+	void PrepareMineLayer();
+
+	/** Sets every hidden mine revealed, or only ones seen by players on chunked map */
+	void RevealMines();
+
+	/** Sets hidden mines inside of bounds (end-inclusive) revealed, sending new version of grid map to players seeing them except of given one */
+	void RevealMinesInBounds(const FIntRect& Bounds, class AMinesweeperPlayerControllerBase* SkippedPlayer);
+
+	/** Opens mine-free cell, automatically opening area around it if it has no mines around */
+	void OpenClearCells(const FIntPoint& EnteredCoords);
+
+	void OpenClearCell(const FIntPoint& CellCoords);
+	void OpenClearCellAt(const int32 CellIndex);
 };
@@ -2,15 +2,37 @@
 
 #include "CoreMinimal.h"
 #include "MineGridMapCell.h"
+#include "MineGridWindow.h"
 
 #include "MineGridMap.generated.h"
 
+UENUM(BlueprintType)
+enum class EMineGridMapStorage : uint8
+{
+	MGMS_Map, // Cell values are held in hash map keyed by coordinates
+	MGMS_Dense, // Cell values are nibble-packed in row-major array
+	MGMS_Chunked, // Cell values are nibble-packed in fixed-size tiles allocated on first change
+	MGMS_Window, // Cell values are held in toroidal window indexed by coordinates modulo its dimensions
+
+	MGMS_MAX
+};
+
+UENUM(BlueprintType)
+enum class EMineGridMapTileSummary : uint8
+{
+	MGMTS_AllUndiscovered, // No cell of tile is "stepped on" yet
+	MGMTS_Mixed,
+	MGMTS_AllDiscovered, // Every cell of tile is either opened or revealed
+
+	MGMTS_MAX
+};
+
 USTRUCT(BlueprintType)
 struct FMineGridMap
 {
 	GENERATED_BODY()
 
-	/** Represents mapping between coordinates and enumerable cell values */
+	/** Represents mapping between coordinates and enumerable cell values. Populated only in map storage mode. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	TMap<FIntPoint, EMineGridMapCell> Cells;
 
@@ -25,4 +47,406 @@ struct FMineGridMap
 	/** Represents last cell in last row */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	FIntPoint EndCoords = FIntPoint(-1, -1);
+
+	/** Represents where cell values are held */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	EMineGridMapStorage Storage = EMineGridMapStorage::MGMS_Map;
+
+	/** Cell values of dense storage, two cells per byte with lower nibble being even column */
+	UPROPERTY()
+	TArray<uint8> PackedCells;
+
+	/** Number of cells per packed row, including padding to whole byte */
+	UPROPERTY()
+	int32 RowStride = 0;
+
+	/**
+	 * Cell values of window storage. Bounds moving within window only reuse cells of wrapped edge rows and columns,
+	 * so map area following pawn is kept without hashing any coords. Not exposed, being viewed by ExportCells.
+	 */
+	TMineGridWindow<EMineGridMapCell> WindowCells;
+
+	/** Number of rows and columns of cells in a tile of chunked storage */
+	static constexpr int32 TileSizeLog2 = 6;
+	static constexpr int32 TileSize = 1 << TileSizeLog2;
+	static constexpr int32 TileNumBytes = TileSize * TileSize / 2;
+
+	/** Slot of every allocated tile of chunked storage. Tiles without slot have all cells undiscovered. */
+	UPROPERTY()
+	TMap<FIntPoint, int32> TileSlots;
+
+	/** Cell values of allocated tiles, nibble-packed in row-major order of each tile */
+	UPROPERTY()
+	TArray<uint8> TileCells;
+
+	/** Number of cells of every allocated tile which are not undiscovered anymore */
+	UPROPERTY()
+	TArray<int32> TileNumDiscovered;
+
+	/** Switches map to dense storage of given dimensions, filling every cell with initial value */
+	void InitDense(const FIntPoint& InGridDimensions, const EMineGridMapCell InitialValue)
+	{
+		Storage = EMineGridMapStorage::MGMS_Dense;
+		Cells.Empty();
+		WindowCells = TMineGridWindow<EMineGridMapCell>();
+		TileSlots.Empty();
+		TileCells.Empty();
+		TileNumDiscovered.Empty();
+
+		GridDimensions = InGridDimensions;
+		StartCoords = FIntPoint::ZeroValue;
+		EndCoords = GridDimensions - 1;
+
+		// Pad rows to whole bytes so every row span starts at byte boundary
+		RowStride = Align(GridDimensions.X, 2);
+
+		const uint8 InitialPair = (uint8)InitialValue | ((uint8)InitialValue << 4);
+		PackedCells.Init(InitialPair, RowStride / 2 * GridDimensions.Y);
+	}
+
+	/**
+	 * Switches map to chunked storage of given dimensions, all cells being undiscovered.
+	 * Memory is allocated only for tiles containing discovered cells.
+	 */
+	void InitChunked(const FIntPoint& InGridDimensions)
+	{
+		Storage = EMineGridMapStorage::MGMS_Chunked;
+		Cells.Empty();
+		PackedCells.Empty();
+		WindowCells = TMineGridWindow<EMineGridMapCell>();
+
+		GridDimensions = InGridDimensions;
+		StartCoords = FIntPoint::ZeroValue;
+		EndCoords = GridDimensions - 1;
+		RowStride = Align(GridDimensions.X, 2);
+
+		TileSlots.Empty();
+		TileCells.Empty();
+		TileNumDiscovered.Empty();
+		CachedTileCoords = FIntPoint(-1, -1);
+		CachedTileSlot = INDEX_NONE;
+	}
+
+	/**
+	 * Switches map to window storage holding bounds of at least given dimensions, with no cells and empty bounds.
+	 * Cells are held only once set, and only inside of current bounds.
+	 */
+	void InitWindow(const FIntPoint& MinDimensions)
+	{
+		Storage = EMineGridMapStorage::MGMS_Window;
+		Cells.Empty();
+		PackedCells.Empty();
+		TileSlots.Empty();
+		TileCells.Empty();
+		TileNumDiscovered.Empty();
+
+		GridDimensions = FIntPoint::ZeroValue;
+		StartCoords = FIntPoint(0, 0);
+		EndCoords = FIntPoint(-1, -1);
+		RowStride = 0;
+
+		WindowCells = TMineGridWindow<EMineGridMapCell>();
+		WindowCells.Reserve(MinDimensions);
+	}
+
+	/** Grows window storage to hold bounds of at least given dimensions, moving held cells into it */
+	void ReserveWindow(const FIntPoint& MinDimensions)
+	{
+		check(IsWindowed());
+		WindowCells.Reserve(MinDimensions);
+	}
+
+	FORCEINLINE bool IsDense() const { return Storage == EMineGridMapStorage::MGMS_Dense; }
+
+	FORCEINLINE bool IsChunked() const { return Storage == EMineGridMapStorage::MGMS_Chunked; }
+
+	FORCEINLINE bool IsWindowed() const { return Storage == EMineGridMapStorage::MGMS_Window; }
+
+	FORCEINLINE int32 Num() const { return GridDimensions.X * GridDimensions.Y; }
+
+	FORCEINLINE bool IsValidCoords(const FIntPoint& Coords) const
+	{
+		return Coords.X >= StartCoords.X && Coords.X <= EndCoords.X
+			&& Coords.Y >= StartCoords.Y && Coords.Y <= EndCoords.Y;
+	}
+
+	/** Dense storage index of cell at given coords. Neighbouring cells of the same row have consecutive indices. */
+	FORCEINLINE int32 GetCellIndex(const FIntPoint& Coords) const
+	{
+		return (Coords.Y - StartCoords.Y) * RowStride + (Coords.X - StartCoords.X);
+	}
+
+	FORCEINLINE FIntPoint GetCellCoords(const int32 Index) const
+	{
+		return StartCoords + FIntPoint(Index % RowStride, Index / RowStride);
+	}
+
+	FORCEINLINE EMineGridMapCell GetCellAt(const int32 Index) const
+	{
+		checkSlow(PackedCells.IsValidIndex(Index >> 1));
+		return (EMineGridMapCell)((PackedCells.GetData()[Index >> 1] >> ((Index & 1) << 2)) & 0xF);
+	}
+
+	FORCEINLINE void SetCellAt(const int32 Index, const EMineGridMapCell Value)
+	{
+		checkSlow(PackedCells.IsValidIndex(Index >> 1));
+		uint8& Pair = PackedCells.GetData()[Index >> 1];
+		const int32 Shift = (Index & 1) << 2;
+		Pair = (uint8)((Pair & ~(0xF << Shift)) | ((uint8)Value << Shift));
+	}
+
+	/** Packed bytes of single row in dense storage */
+	FORCEINLINE TArrayView<const uint8> GetPackedRow(const int32 Row) const
+	{
+		return MakeArrayView(PackedCells.GetData() + Row * (RowStride / 2), RowStride / 2);
+	}
+
+	FORCEINLINE FIntPoint GetTileCoords(const FIntPoint& Coords) const
+	{
+		return FIntPoint((Coords.X - StartCoords.X) >> TileSizeLog2, (Coords.Y - StartCoords.Y) >> TileSizeLog2);
+	}
+
+	/** Index of cell inside of its tile */
+	FORCEINLINE int32 GetTileCellIndex(const FIntPoint& Coords) const
+	{
+		return (((Coords.Y - StartCoords.Y) & (TileSize - 1)) << TileSizeLog2) | ((Coords.X - StartCoords.X) & (TileSize - 1));
+	}
+
+	/** Slot of allocated tile, INDEX_NONE if tile is not allocated. Remembers last tile, as cells are mostly accessed tile by tile. */
+	int32 FindTileSlot(const FIntPoint& TileCoords) const
+	{
+		if (TileCoords != CachedTileCoords)
+		{
+			const int32* FoundSlot = TileSlots.Find(TileCoords);
+			CachedTileCoords = TileCoords;
+			CachedTileSlot = FoundSlot ? *FoundSlot : INDEX_NONE;
+		}
+		return CachedTileSlot;
+	}
+
+	EMineGridMapCell GetChunkedCell(const FIntPoint& Coords) const
+	{
+		const int32 Slot = FindTileSlot(GetTileCoords(Coords));
+		if (Slot == INDEX_NONE)
+		{
+			return EMineGridMapCell::MGMC_Undiscovered;
+		}
+
+		const int32 TileCellIndex = GetTileCellIndex(Coords);
+		return (EMineGridMapCell)((TileCells[Slot * TileNumBytes + (TileCellIndex >> 1)] >> ((TileCellIndex & 1) << 2)) & 0xF);
+	}
+
+	void SetChunkedCell(const FIntPoint& Coords, const EMineGridMapCell Value)
+	{
+		const FIntPoint TileCoords = GetTileCoords(Coords);
+		int32 Slot = FindTileSlot(TileCoords);
+
+		if (Slot == INDEX_NONE)
+		{
+			// Untouched tile already reads as undiscovered
+			if (Value == EMineGridMapCell::MGMC_Undiscovered)
+			{
+				return;
+			}
+
+			// Allocate tile on first touch
+			const uint8 UndiscoveredPair = (uint8)EMineGridMapCell::MGMC_Undiscovered | ((uint8)EMineGridMapCell::MGMC_Undiscovered << 4);
+			Slot = TileNumDiscovered.Add(0);
+			TileCells.AddUninitialized(TileNumBytes);
+			FMemory::Memset(TileCells.GetData() + Slot * TileNumBytes, UndiscoveredPair, TileNumBytes);
+
+			TileSlots.Add(TileCoords, Slot);
+			CachedTileCoords = TileCoords;
+			CachedTileSlot = Slot;
+		}
+
+		const int32 TileCellIndex = GetTileCellIndex(Coords);
+		const int32 Shift = (TileCellIndex & 1) << 2;
+		uint8& Pair = TileCells[Slot * TileNumBytes + (TileCellIndex >> 1)];
+
+		const bool bWasUndiscovered = ((Pair >> Shift) & 0xF) == (uint8)EMineGridMapCell::MGMC_Undiscovered;
+		const bool bIsUndiscovered = Value == EMineGridMapCell::MGMC_Undiscovered;
+		TileNumDiscovered[Slot] += (int32)bWasUndiscovered - (int32)bIsUndiscovered;
+
+		Pair = (uint8)((Pair & ~(0xF << Shift)) | ((uint8)Value << Shift));
+	}
+
+	/** Number of cells of tile lying inside of the map */
+	int32 GetTileNumCells(const FIntPoint& TileCoords) const
+	{
+		const int32 NumColumns = FMath::Min(TileSize, GridDimensions.X - (TileCoords.X << TileSizeLog2));
+		const int32 NumRows = FMath::Min(TileSize, GridDimensions.Y - (TileCoords.Y << TileSizeLog2));
+
+		return FMath::Max(NumColumns, 0) * FMath::Max(NumRows, 0);
+	}
+
+	/** Tells whether tile cells are all undiscovered or all discovered. Known only in chunked storage. */
+	EMineGridMapTileSummary GetTileSummary(const FIntPoint& TileCoords) const
+	{
+		if (!IsChunked())
+		{
+			return EMineGridMapTileSummary::MGMTS_Mixed;
+		}
+
+		const int32 Slot = FindTileSlot(TileCoords);
+		const int32 NumDiscovered = Slot != INDEX_NONE ? TileNumDiscovered[Slot] : 0;
+
+		if (NumDiscovered == 0)
+		{
+			return EMineGridMapTileSummary::MGMTS_AllUndiscovered;
+		}
+		return NumDiscovered == GetTileNumCells(TileCoords) ? EMineGridMapTileSummary::MGMTS_AllDiscovered : EMineGridMapTileSummary::MGMTS_Mixed;
+	}
+
+	/** Retrieves cell value if coords are inside the map, regardless of storage */
+	bool TryGetCell(const FIntPoint& Coords, EMineGridMapCell& OutValue) const
+	{
+		if (!IsValidCoords(Coords))
+		{
+			return false;
+		}
+
+		if (IsDense())
+		{
+			OutValue = GetCellAt(GetCellIndex(Coords));
+			return true;
+		}
+
+		if (IsChunked())
+		{
+			OutValue = GetChunkedCell(Coords);
+			return true;
+		}
+
+		if (IsWindowed())
+		{
+			if (const EMineGridMapCell* FoundValue = WindowCells.Find(Coords))
+			{
+				OutValue = *FoundValue;
+				return true;
+			}
+			return false;
+		}
+
+		if (const EMineGridMapCell* FoundValue = Cells.Find(Coords))
+		{
+			OutValue = *FoundValue;
+			return true;
+		}
+		return false;
+	}
+
+	EMineGridMapCell GetCell(const FIntPoint& Coords) const
+	{
+		check(IsValidCoords(Coords));
+		if (IsDense())
+		{
+			return GetCellAt(GetCellIndex(Coords));
+		}
+		if (IsWindowed())
+		{
+			return WindowCells.FindChecked(Coords);
+		}
+		return IsChunked() ? GetChunkedCell(Coords) : Cells.FindChecked(Coords);
+	}
+
+	void SetCell(const FIntPoint& Coords, const EMineGridMapCell Value)
+	{
+		check(IsValidCoords(Coords));
+		if (IsDense())
+		{
+			SetCellAt(GetCellIndex(Coords), Value);
+		}
+		else if (IsChunked())
+		{
+			SetChunkedCell(Coords, Value);
+		}
+		else if (IsWindowed())
+		{
+			WindowCells.Add(Coords, Value);
+		}
+		else
+		{
+			Cells.Emplace(Coords, Value);
+		}
+	}
+
+	/** Whether cell at given coords is held, every cell inside of dense and chunked storages being held */
+	bool HasCell(const FIntPoint& Coords) const
+	{
+		if (!IsValidCoords(Coords))
+		{
+			return false;
+		}
+
+		if (IsWindowed())
+		{
+			return WindowCells.Contains(Coords);
+		}
+		return IsDense() || IsChunked() || Cells.Contains(Coords);
+	}
+
+	/**
+	 * Drops cell of map or window storage. Cell of window storage may already be outside of bounds,
+	 * as cells left behind by moving bounds are dropped after they move.
+	 */
+	void RemoveCell(const FIntPoint& Coords)
+	{
+		if (IsWindowed())
+		{
+			WindowCells.Remove(Coords);
+		}
+		else if (!IsDense() && !IsChunked())
+		{
+			Cells.Remove(Coords);
+		}
+	}
+
+	/** Invokes given function with coords and value of every cell held, row by row unless held in map storage */
+	template<typename FuncType>
+	void ForEachCell(FuncType Func) const
+	{
+		if (!IsDense() && !IsChunked() && !IsWindowed())
+		{
+			for (const TPair<FIntPoint, EMineGridMapCell>& Cell : Cells)
+			{
+				Func(Cell.Key, Cell.Value);
+			}
+			return;
+		}
+
+		for (int32 Y = StartCoords.Y; Y <= EndCoords.Y; Y++)
+		{
+			for (int32 X = StartCoords.X; X <= EndCoords.X; X++)
+			{
+				EMineGridMapCell CellValue;
+				if (TryGetCell(FIntPoint(X, Y), CellValue))
+				{
+					Func(FIntPoint(X, Y), CellValue);
+				}
+			}
+		}
+	}
+
+	/** Builds coords to value mapping of every cell, used as a view of dense, chunked and window storages */
+	void ExportCells(TMap<FIntPoint, EMineGridMapCell>& OutCells) const
+	{
+		if (!IsDense() && !IsChunked() && !IsWindowed())
+		{
+			OutCells = Cells;
+			return;
+		}
+
+		OutCells.Empty(Num());
+		ForEachCell([&OutCells](const FIntPoint& Coords, const EMineGridMapCell CellValue)
+		{
+			OutCells.Emplace(Coords, CellValue);
+		});
+	}
+
+private:
+
+	/** Last looked up tile of chunked storage */
+	mutable FIntPoint CachedTileCoords = FIntPoint(-1, -1);
+	mutable int32 CachedTileSlot = INDEX_NONE;
 };
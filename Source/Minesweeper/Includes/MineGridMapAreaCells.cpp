@@ -0,0 +1,620 @@
+#include "MineGridMapAreaCells.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "Minesweeper/Player/MinesweeperPlayerControllerBase.h"
+
+namespace MineGridMapAreaCells
+{
+	// Least number of cells of rect to be sent as rect, smaller ones being cheaper as sparse coords
+	static constexpr int32 MinRectNumCells = 3;
+
+	// Largest number of cells accepted from network by single delta
+	static constexpr int32 MaxNumCells = 1 << 20;
+
+	FORCEINLINE uint32 ZigZag(const int32 Value)
+	{
+		return ((uint32)Value << 1) ^ (uint32)(Value >> 31);
+	}
+
+	FORCEINLINE int32 UnZigZag(const uint32 Value)
+	{
+		return (int32)(Value >> 1) ^ -(int32)(Value & 1);
+	}
+
+	FORCEINLINE void SerializeSigned(FArchive& Ar, int32& Value)
+	{
+		uint32 Packed = ZigZag(Value);
+		Ar.SerializeIntPacked(Packed);
+		Value = UnZigZag(Packed);
+	}
+
+	/** Offsets coords by delta and extent, failing if any of resulting coords would not fit into int32 */
+	FORCEINLINE bool OffsetCoords(const FIntPoint& Coords, const FIntPoint& Delta, const FIntPoint& Extent, FIntPoint& OutCoords)
+	{
+		const int64 X = (int64)Coords.X + Delta.X;
+		const int64 Y = (int64)Coords.Y + Delta.Y;
+		if (X < MIN_int32 || Y < MIN_int32 || X + Extent.X > MAX_int32 || Y + Extent.Y > MAX_int32)
+		{
+			return false;
+		}
+
+		OutCoords = FIntPoint((int32)X, (int32)Y);
+		return true;
+	}
+
+	/** Run of coords being either rows of rect in row order or sparse coords */
+	struct FCoordsBlock
+	{
+		int32 NumCells;
+		bool bIsRect;
+		FIntPoint Min;
+		FIntPoint Size;
+	};
+
+	/** Splits coords into rects of contiguous coords in row order and sparse coords in between */
+	void SplitCoordsIntoBlocks(const TArray<FIntPoint>& Coords, TArray<FCoordsBlock>& OutBlocks)
+	{
+		int32 Index = 0;
+		while (Index < Coords.Num())
+		{
+			const FIntPoint Min = Coords[Index];
+
+			// Extend first row, then following rows of the same width
+			int32 Width = 1;
+			while (Index + Width < Coords.Num() && Coords[Index + Width] == FIntPoint(Min.X + Width, Min.Y))
+			{
+				Width++;
+			}
+
+			int32 Height = 1;
+			for (bool bIsRowMatching = true; bIsRowMatching && Index + Width * (Height + 1) <= Coords.Num(); )
+			{
+				const int32 RowIndex = Index + Width * Height;
+				for (int32 Column = 0; bIsRowMatching && Column < Width; Column++)
+				{
+					bIsRowMatching = Coords[RowIndex + Column] == FIntPoint(Min.X + Column, Min.Y + Height);
+				}
+				Height += bIsRowMatching ? 1 : 0;
+			}
+
+			if (Width * Height >= MinRectNumCells)
+			{
+				OutBlocks.Add({ Width * Height, true, Min, FIntPoint(Width, Height) });
+				Index += Width * Height;
+			}
+			else
+			{
+				if (OutBlocks.Num() == 0 || OutBlocks.Last().bIsRect)
+				{
+					OutBlocks.Add({ 0, false, FIntPoint::ZeroValue, FIntPoint::ZeroValue });
+				}
+				OutBlocks.Last().NumCells++;
+				Index++;
+			}
+		}
+	}
+
+	/**
+	 * Writes coords as number of blocks followed by blocks. Rect block is header only, its min coords being relative to last 
+	 * coords of previous block, while sparse block holds coords relative to each previous ones.
+	 */
+	void SerializeCoords(FArchive& Ar, TArray<FIntPoint>& Coords)
+	{
+		FIntPoint PrevCoords = FIntPoint::ZeroValue;
+
+		if (Ar.IsSaving())
+		{
+			TArray<FCoordsBlock> Blocks;
+			SplitCoordsIntoBlocks(Coords, Blocks);
+
+			uint32 NumBlocks = Blocks.Num();
+			Ar.SerializeIntPacked(NumBlocks);
+
+			int32 Index = 0;
+			for (FCoordsBlock& Block : Blocks)
+			{
+				// Lowest bit tells rect from sparse block, the rest holding number of sparse coords
+				uint32 Header = Block.bIsRect ? 1 : (uint32)Block.NumCells << 1;
+				Ar.SerializeIntPacked(Header);
+
+				if (Block.bIsRect)
+				{
+					FIntPoint Delta = Block.Min - PrevCoords;
+					uint32 Width = (uint32)(Block.Size.X - 1);
+					uint32 Height = (uint32)(Block.Size.Y - 1);
+
+					SerializeSigned(Ar, Delta.X);
+					SerializeSigned(Ar, Delta.Y);
+					Ar.SerializeIntPacked(Width);
+					Ar.SerializeIntPacked(Height);
+
+					PrevCoords = Block.Min + Block.Size - 1;
+				}
+				else
+				{
+					for (int32 SparseIndex = Index; SparseIndex < Index + Block.NumCells; SparseIndex++)
+					{
+						FIntPoint Delta = Coords[SparseIndex] - PrevCoords;
+						SerializeSigned(Ar, Delta.X);
+						SerializeSigned(Ar, Delta.Y);
+
+						PrevCoords = Coords[SparseIndex];
+					}
+				}
+
+				Index += Block.NumCells;
+			}
+		}
+		else
+		{
+			uint32 NumBlocks = 0;
+			Ar.SerializeIntPacked(NumBlocks);
+
+			Coords.Reset();
+			for (uint32 BlockIndex = 0; BlockIndex < NumBlocks && !Ar.IsError(); BlockIndex++)
+			{
+				uint32 Header = 0;
+				Ar.SerializeIntPacked(Header);
+
+				if (Header & 1)
+				{
+					FIntPoint Delta = FIntPoint::ZeroValue;
+					uint32 Width = 0;
+					uint32 Height = 0;
+
+					SerializeSigned(Ar, Delta.X);
+					SerializeSigned(Ar, Delta.Y);
+					Ar.SerializeIntPacked(Width);
+					Ar.SerializeIntPacked(Height);
+
+					// Each extent is capped first, so their product cannot wrap around
+					if (Width >= MaxNumCells || Height >= MaxNumCells
+						|| (uint64)Coords.Num() + ((uint64)Width + 1) * ((uint64)Height + 1) > MaxNumCells)
+					{
+						Ar.SetError();
+						break;
+					}
+
+					// Min coords from network are arbitrary, so rect is to end within int32 range
+					FIntPoint Min;
+					if (!OffsetCoords(PrevCoords, Delta, FIntPoint((int32)Width, (int32)Height), Min))
+					{
+						Ar.SetError();
+						break;
+					}
+
+					for (int32 Row = 0; Row <= (int32)Height; Row++)
+					{
+						for (int32 Column = 0; Column <= (int32)Width; Column++)
+						{
+							Coords.Emplace(Min.X + Column, Min.Y + Row);
+						}
+					}
+
+					PrevCoords = Min + FIntPoint((int32)Width, (int32)Height);
+				}
+				else
+				{
+					const uint32 NumSparseCoords = Header >> 1;
+					if ((uint64)Coords.Num() + NumSparseCoords > MaxNumCells)
+					{
+						Ar.SetError();
+						break;
+					}
+
+					for (uint32 SparseIndex = 0; SparseIndex < NumSparseCoords && !Ar.IsError(); SparseIndex++)
+					{
+						FIntPoint Delta = FIntPoint::ZeroValue;
+						SerializeSigned(Ar, Delta.X);
+						SerializeSigned(Ar, Delta.Y);
+
+						if (!OffsetCoords(PrevCoords, Delta, FIntPoint::ZeroValue, PrevCoords))
+						{
+							Ar.SetError();
+							break;
+						}
+						Coords.Add(PrevCoords);
+					}
+				}
+			}
+		}
+	}
+
+	/** Orders coords row by row, so contiguous ones form rects */
+	FORCEINLINE bool IsRowMajorLess(const FIntPoint& A, const FIntPoint& B)
+	{
+		return A.Y < B.Y || (A.Y == B.Y && A.X < B.X);
+	}
+
+	/** Writes number of values followed by values packed two per byte, lower nibble first */
+	void SerializeValues(FArchive& Ar, TArray<EMineGridMapCell>& Values)
+	{
+		uint32 NumValues = Values.Num();
+		Ar.SerializeIntPacked(NumValues);
+
+		if (Ar.IsLoading() && NumValues > MaxNumCells)
+		{
+			Ar.SetError();
+			return;
+		}
+
+		TArray<uint8> PackedValues;
+		PackedValues.SetNumZeroed((NumValues + 1) / 2);
+
+		if (Ar.IsSaving())
+		{
+			for (int32 Index = 0; Index < (int32)NumValues; Index++)
+			{
+				PackedValues[Index >> 1] |= ((uint8)Values[Index] & 0xF) << ((Index & 1) << 2);
+			}
+		}
+
+		Ar.Serialize(PackedValues.GetData(), PackedValues.Num());
+
+		if (Ar.IsLoading())
+		{
+			Values.SetNumUninitialized(NumValues);
+			for (int32 Index = 0; Index < (int32)NumValues; Index++)
+			{
+				const uint8 Value = (PackedValues[Index >> 1] >> ((Index & 1) << 2)) & 0xF;
+				Values[Index] = Value < (uint8)EMineGridMapCell::MGMC_MAX ? (EMineGridMapCell)Value : EMineGridMapCell::MGMC_Undiscovered;
+			}
+		}
+	}
+
+	/** Cells as of delta client acknowledged, next delta being sent against them */
+	struct FDeltaState : public INetDeltaBaseState
+	{
+		int32 ArrayReplicationKey = INDEX_NONE;
+
+		TMap<FIntPoint, EMineGridMapCell> Cells;
+
+		virtual bool IsStateEqual(INetDeltaBaseState* OtherState) override
+		{
+			const FDeltaState* OtherDeltaState = static_cast<const FDeltaState*>(OtherState);
+			return ArrayReplicationKey == OtherDeltaState->ArrayReplicationKey && Cells.OrderIndependentCompareEqual(OtherDeltaState->Cells);
+		}
+	};
+}
+
+void FMineGridMapAreaCells::AddCell(const FIntPoint& Coords, const EMineGridMapCell Value)
+{
+	if (const int32* ItemIndex = ItemIndices.Find(Coords))
+	{
+		// Cell is cached on client already, only its value may need sending
+		FMineGridMapAreaCell& Item = Items[*ItemIndex];
+		if (Item.EvictionSerial != INDEX_NONE)
+		{
+			Item.EvictionSerial = INDEX_NONE;
+			NumEvictedCells--;
+		}
+
+		UpdateCell(Coords, Value);
+		return;
+	}
+
+	// Cached cell gives its window slot up to cell entering area, as cells of area are looked up far more often
+	FIntPoint SlotCoords;
+	if (ItemIndices.FindSlotCoords(Coords, SlotCoords) && Items[ItemIndices.FindChecked(SlotCoords)].EvictionSerial != INDEX_NONE)
+	{
+		RemoveCell(SlotCoords);
+	}
+
+	FMineGridMapAreaCell& Item = Items.AddDefaulted_GetRef();
+	Item.Coords = Coords;
+	Item.Value = Value;
+
+	ItemIndices.Add(Coords, Items.Num() - 1);
+	MarkItemDirty(Item);
+}
+
+void FMineGridMapAreaCells::RemoveCell(const FIntPoint& Coords)
+{
+	int32 ItemIndex;
+	if (!ItemIndices.RemoveAndCopyValue(Coords, ItemIndex))
+	{
+		return;
+	}
+
+	if (Items[ItemIndex].EvictionSerial != INDEX_NONE)
+	{
+		NumEvictedCells--;
+	}
+
+	// Move last item into place of removed one
+	Items.RemoveAtSwap(ItemIndex, 1, false);
+	if (ItemIndex < Items.Num())
+	{
+		ItemIndices.FindChecked(Items[ItemIndex].Coords) = ItemIndex;
+	}
+
+	MarkArrayDirty();
+}
+
+void FMineGridMapAreaCells::UpdateCell(const FIntPoint& Coords, const EMineGridMapCell Value)
+{
+	if (const int32* ItemIndex = ItemIndices.Find(Coords))
+	{
+		FMineGridMapAreaCell& Item = Items[*ItemIndex];
+		if (Item.Value != Value)
+		{
+			Item.Value = Value;
+			MarkItemDirty(Item);
+		}
+	}
+}
+
+void FMineGridMapAreaCells::EvictCell(const FIntPoint& Coords, const int32 MaxNumEvictedCells)
+{
+	const int32* ItemIndex = ItemIndices.Find(Coords);
+	if (!ItemIndex)
+	{
+		return;
+	}
+
+	FMineGridMapAreaCell& Item = Items[*ItemIndex];
+	if (Item.EvictionSerial == INDEX_NONE)
+	{
+		NumEvictedCells++;
+	}
+
+	Item.EvictionSerial = NextEvictionSerial++;
+	EvictionOrder.Emplace(Coords, Item.EvictionSerial);
+
+	while (NumEvictedCells > FMath::Max(MaxNumEvictedCells, 0))
+	{
+		const TPair<FIntPoint, int32> Eviction = EvictionOrder[EvictionOrderHead++];
+
+		// Skip cells brought back or evicted again since
+		if (IsLatestEviction(Eviction))
+		{
+			RemoveCell(Eviction.Key);
+		}
+	}
+
+	// Cells brought back and removed leave their evictions behind, so drop them once they outnumber held ones
+	if (EvictionOrder.Num() > 2 * NumEvictedCells + 64)
+	{
+		CompactEvictionOrder();
+	}
+}
+
+void FMineGridMapAreaCells::RemoveEvictedCells()
+{
+	TArray<FIntPoint> EvictedCells;
+	EvictedCells.Reserve(NumEvictedCells);
+
+	for (const FMineGridMapAreaCell& Item : Items)
+	{
+		if (Item.EvictionSerial != INDEX_NONE)
+		{
+			EvictedCells.Add(Item.Coords);
+		}
+	}
+
+	for (const FIntPoint& EvictedCellCoords : EvictedCells)
+	{
+		RemoveCell(EvictedCellCoords);
+	}
+
+	EvictionOrder.Reset();
+	EvictionOrderHead = 0;
+}
+
+void FMineGridMapAreaCells::CompactEvictionOrder()
+{
+	int32 NumKeptEvictions = 0;
+	for (int32 EvictionIndex = EvictionOrderHead; EvictionIndex < EvictionOrder.Num(); EvictionIndex++)
+	{
+		const TPair<FIntPoint, int32>& Eviction = EvictionOrder[EvictionIndex];
+
+		if (IsLatestEviction(Eviction))
+		{
+			EvictionOrder[NumKeptEvictions++] = Eviction;
+		}
+	}
+
+	EvictionOrder.SetNum(NumKeptEvictions, false);
+	EvictionOrderHead = 0;
+}
+
+bool FMineGridMapAreaCells::IsLatestEviction(const TPair<FIntPoint, int32>& Eviction) const
+{
+	const int32* ItemIndex = ItemIndices.Find(Eviction.Key);
+	return ItemIndex && Items[*ItemIndex].EvictionSerial == Eviction.Value;
+}
+
+void FMineGridMapAreaCells::PreReplicatedRemove(const TArrayView<int32>& RemovedIndices, int32 FinalSize)
+{
+	TArray<FIntPoint> RemovedCells;
+	RemovedCells.Reserve(RemovedIndices.Num());
+
+	for (const int32 ItemIndex : RemovedIndices)
+	{
+		ReplicatedCells.Remove(Items[ItemIndex].Coords);
+		RemovedCells.Add(Items[ItemIndex].Coords);
+	}
+
+	if (OwningController)
+	{
+		OwningController->HandleOnMapAreaCellsRemoved(RemovedCells);
+	}
+}
+
+void FMineGridMapAreaCells::PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize)
+{
+	TArray<FIntPoint> AddedCells;
+	AddedCells.Reserve(AddedIndices.Num());
+
+	for (const int32 ItemIndex : AddedIndices)
+	{
+		ReplicatedCells.Add(Items[ItemIndex].Coords, Items[ItemIndex].Value);
+		AddedCells.Add(Items[ItemIndex].Coords);
+	}
+
+	if (OwningController)
+	{
+		OwningController->HandleOnMapAreaCellsReplicated(AddedCells);
+	}
+}
+
+void FMineGridMapAreaCells::PostReplicatedChange(const TArrayView<int32>& ChangedIndices, int32 FinalSize)
+{
+	TArray<FIntPoint> ChangedCells;
+	ChangedCells.Reserve(ChangedIndices.Num());
+
+	for (const int32 ItemIndex : ChangedIndices)
+	{
+		ReplicatedCells.Add(Items[ItemIndex].Coords, Items[ItemIndex].Value);
+		ChangedCells.Add(Items[ItemIndex].Coords);
+	}
+
+	if (OwningController)
+	{
+		OwningController->HandleOnMapAreaCellsReplicated(ChangedCells);
+	}
+}
+
+bool FMineGridMapAreaCells::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+	using namespace MineGridMapAreaCells;
+
+	if (DeltaParms.Writer)
+	{
+		const FDeltaState* OldState = static_cast<const FDeltaState*>(DeltaParms.OldState);
+
+		TSharedPtr<FDeltaState> NewState = MakeShared<FDeltaState>();
+		NewState->ArrayReplicationKey = ArrayReplicationKey;
+		*DeltaParms.NewState = NewState;
+
+		// No cell was marked dirty since acknowledged state
+		if (OldState && OldState->ArrayReplicationKey == ArrayReplicationKey)
+		{
+			NewState->Cells = OldState->Cells;
+			return false;
+		}
+
+		TArray<FIntPoint> ChangedCoords;
+		NewState->Cells.Reserve(Items.Num());
+		for (const FMineGridMapAreaCell& Item : Items)
+		{
+			NewState->Cells.Add(Item.Coords, Item.Value);
+
+			const EMineGridMapCell* OldValue = OldState ? OldState->Cells.Find(Item.Coords) : nullptr;
+			if (!OldValue || *OldValue != Item.Value)
+			{
+				ChangedCoords.Add(Item.Coords);
+			}
+		}
+
+		TArray<FIntPoint> RemovedCoords;
+		if (OldState)
+		{
+			for (const TPair<FIntPoint, EMineGridMapCell>& OldCell : OldState->Cells)
+			{
+				if (!NewState->Cells.Contains(OldCell.Key))
+				{
+					RemovedCoords.Add(OldCell.Key);
+				}
+			}
+		}
+
+		if (RemovedCoords.Num() == 0 && ChangedCoords.Num() == 0)
+		{
+			return false;
+		}
+
+		RemovedCoords.Sort(&IsRowMajorLess);
+		ChangedCoords.Sort(&IsRowMajorLess);
+
+		TArray<EMineGridMapCell> ChangedValues;
+		ChangedValues.Reserve(ChangedCoords.Num());
+		for (const FIntPoint& Coords : ChangedCoords)
+		{
+			ChangedValues.Add(NewState->Cells.FindChecked(Coords));
+		}
+
+		FArchive& Writer = *DeltaParms.Writer;
+		SerializeCoords(Writer, RemovedCoords);
+		SerializeCoords(Writer, ChangedCoords);
+		SerializeValues(Writer, ChangedValues);
+
+		return true;
+	}
+
+	if (DeltaParms.Reader)
+	{
+		FArchive& Reader = *DeltaParms.Reader;
+
+		TArray<FIntPoint> RemovedCoords;
+		TArray<FIntPoint> ChangedCoords;
+		TArray<EMineGridMapCell> ChangedValues;
+		SerializeCoords(Reader, RemovedCoords);
+		SerializeCoords(Reader, ChangedCoords);
+		SerializeValues(Reader, ChangedValues);
+
+		if (Reader.IsError() || ChangedValues.Num() != ChangedCoords.Num())
+		{
+			Reader.SetError();
+			return false;
+		}
+
+		ApplyReplicatedDelta(RemovedCoords, ChangedCoords, ChangedValues);
+		return true;
+	}
+
+	// Cells hold no object references, so there is nothing to map
+	return false;
+}
+
+void FMineGridMapAreaCells::ApplyReplicatedDelta(const TArray<FIntPoint>& RemovedCoords, const TArray<FIntPoint>& ChangedCoords, const TArray<EMineGridMapCell>& ChangedValues)
+{
+	// Delta may be sent against older state than client has, so cells already removed or added are taken as they are
+	TArray<int32> RemovedIndices;
+	for (const FIntPoint& Coords : RemovedCoords)
+	{
+		if (const int32* ItemIndex = ItemIndices.Find(Coords))
+		{
+			RemovedIndices.AddUnique(*ItemIndex);
+		}
+	}
+
+	if (RemovedIndices.Num() > 0)
+	{
+		PreReplicatedRemove(RemovedIndices, Items.Num() - RemovedIndices.Num());
+
+		for (const FIntPoint& Coords : RemovedCoords)
+		{
+			RemoveCell(Coords);
+		}
+	}
+
+	TArray<int32> AddedIndices;
+	TArray<int32> ChangedIndices;
+	for (int32 Index = 0; Index < ChangedCoords.Num(); Index++)
+	{
+		if (const int32* ItemIndex = ItemIndices.Find(ChangedCoords[Index]))
+		{
+			Items[*ItemIndex].Value = ChangedValues[Index];
+			ChangedIndices.AddUnique(*ItemIndex);
+			continue;
+		}
+
+		FMineGridMapAreaCell& Item = Items.AddDefaulted_GetRef();
+		Item.Coords = ChangedCoords[Index];
+		Item.Value = ChangedValues[Index];
+
+		ItemIndices.Add(Item.Coords, Items.Num() - 1);
+		AddedIndices.Add(Items.Num() - 1);
+	}
+
+	if (AddedIndices.Num() > 0)
+	{
+		PostReplicatedAdd(AddedIndices, Items.Num());
+	}
+
+	if (ChangedIndices.Num() > 0)
+	{
+		PostReplicatedChange(ChangedIndices, Items.Num());
+	}
+}
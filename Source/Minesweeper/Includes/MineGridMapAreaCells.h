@@ -0,0 +1,131 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "MineGridMapCell.h"
+#include "MineGridWindow.h"
+
+#include "MineGridMapAreaCells.generated.h"
+
+/** Bounds (end-inclusive) of player map area */
+USTRUCT()
+struct FMineGridMapAreaBounds
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FIntPoint StartCoords = FIntPoint(0, 0);
+
+	UPROPERTY()
+	FIntPoint EndCoords = FIntPoint(-1, -1);
+
+	FORCEINLINE FIntRect ToRect() const { return FIntRect(StartCoords, EndCoords); }
+};
+
+/** Cell of player map area */
+USTRUCT()
+struct FMineGridMapAreaCell : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FIntPoint Coords = FIntPoint::ZeroValue;
+
+	UPROPERTY()
+	EMineGridMapCell Value = EMineGridMapCell::MGMC_Undiscovered;
+
+	/** Serial of latest eviction of cell, INDEX_NONE unless cell is evicted. Held on server. */
+	UPROPERTY(NotReplicated)
+	int32 EvictionSerial = INDEX_NONE;
+};
+
+/**
+ * Cells of player map area replicated to owning client as deltas, along with cells evicted from it lately. Client shows
+ * cells inside of replicated area bounds, so cells coming back into area cost nothing as long as they stay cached.
+ * Unlike reliable RPCs, replication is bandwidth-limited and sends only latest values, so large changes reach client later
+ * instead of overflowing its reliable buffer.
+ *
+ * Delta against cells client acknowledged is sent as removed and changed coords, each being either rects of contiguous
+ * coords or delta-coded sparse coords, followed by 4-bit packed values of changed cells in the same order.
+ */
+USTRUCT()
+struct FMineGridMapAreaCells : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FMineGridMapAreaCell> Items;
+
+	/** Controller applying replicated changes on client */
+	UPROPERTY(NotReplicated)
+	class AMinesweeperPlayerControllerBase* OwningController = nullptr;
+
+	/**
+	 * Index of item of every cell, held by window following map area. Cached cell aliasing cell entering area
+	 * gives its window slot up on server, so cells of moving area are looked up without hashing.
+	 */
+	TMineGridWindow<int32> ItemIndices;
+
+	/** Number of evicted cells, held on server */
+	int32 NumEvictedCells = 0;
+
+	/** Evictions oldest first, ones with outdated serial being skipped */
+	TArray<TPair<FIntPoint, int32>> EvictionOrder;
+
+	int32 EvictionOrderHead = 0;
+
+	int32 NextEvictionSerial = 0;
+
+	/** Values of replicated cells, held on client by window following map area */
+	TMineGridWindow<EMineGridMapCell> ReplicatedCells;
+
+	/** Adds cell or brings evicted one back, marking it dirty only if its value differs */
+	void AddCell(const FIntPoint& Coords, const EMineGridMapCell Value);
+	void RemoveCell(const FIntPoint& Coords);
+	void UpdateCell(const FIntPoint& Coords, const EMineGridMapCell Value);
+
+	/** Keeps cell cached after leaving area, removing least recently evicted ones above given number */
+	void EvictCell(const FIntPoint& Coords, const int32 MaxNumEvictedCells);
+
+	/** Removes every evicted cell */
+	void RemoveEvictedCells();
+
+	FORCEINLINE bool HasCell(const FIntPoint& Coords) const { return ItemIndices.Contains(Coords); }
+
+	/** Invokes given function with every cell held on server, evicted ones included */
+	template<typename FuncType>
+	void ForEachCell(FuncType Func) const
+	{
+		for (const FMineGridMapAreaCell& Item : Items)
+		{
+			Func(Item.Coords, Item.Value);
+		}
+	}
+
+	void PreReplicatedRemove(const TArrayView<int32>& RemovedIndices, int32 FinalSize);
+	void PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize);
+	void PostReplicatedChange(const TArrayView<int32>& ChangedIndices, int32 FinalSize);
+
+	/** Writes cells changed since state client acknowledged, or applies ones read on client. Malformed delta is not applied. */
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+
+private:
+
+	/** Applies removed and changed cells read on client, invoking replication callbacks the same way as fast array does */
+	void ApplyReplicatedDelta(const TArray<FIntPoint>& RemovedCoords, const TArray<FIntPoint>& ChangedCoords, const TArray<EMineGridMapCell>& ChangedValues);
+
+	/** Drops evictions with outdated serial */
+	void CompactEvictionOrder();
+
+	/** Whether eviction is latest one of cell still held */
+	bool IsLatestEviction(const TPair<FIntPoint, int32>& Eviction) const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FMineGridMapAreaCells> : public TStructOpsTypeTraitsBase2<FMineGridMapAreaCells>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MineGridMapCell.h"
+
+#include "MineGridMapJournal.generated.h"
+
+/** Single cell change of grid map */
+USTRUCT()
+struct FMineGridMapJournalEntry
+{
+	GENERATED_BODY()
+
+	/** Version of grid map the change belongs to */
+	UPROPERTY()
+	int32 Version = 0;
+
+	UPROPERTY()
+	FIntPoint Coords = FIntPoint::ZeroValue;
+
+	UPROPERTY()
+	EMineGridMapCell Value = EMineGridMapCell::MGMC_Undiscovered;
+};
+
+/**
+ * Ring buffer of latest cell changes of grid map, ordered by version. Readers knowing every change up to some version
+ * replay only changes after it, as long as none of them has been overwritten yet.
+ */
+USTRUCT()
+struct FMineGridMapJournal
+{
+	GENERATED_BODY()
+
+	/** Changes in ring order, capacity being power of two */
+	UPROPERTY()
+	TArray<FMineGridMapJournalEntry> Entries;
+
+	/** Total number of changes appended since reset */
+	UPROPERTY()
+	int64 NumAppended = 0;
+
+	/** Lowest version that changes after it are all still held */
+	UPROPERTY()
+	int32 TruncatedVersion = 0;
+
+	/** Drops all changes, sizing ring to hold at least given number of them */
+	void Reset(const int32 BaseVersion, const int32 MinCapacity)
+	{
+		const int32 Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max(MinCapacity, 1));
+		if (Entries.Num() != Capacity)
+		{
+			Entries.SetNum(Capacity);
+		}
+
+		NumAppended = 0;
+		TruncatedVersion = BaseVersion;
+	}
+
+	FORCEINLINE int32 Num() const { return (int32)FMath::Min<int64>(NumAppended, Entries.Num()); }
+
+	void Append(const int32 Version, const FIntPoint& Coords, const EMineGridMapCell Value)
+	{
+		if (Entries.Num() == 0)
+		{
+			return;
+		}
+
+		FMineGridMapJournalEntry& Entry = Entries[(int32)(NumAppended & (Entries.Num() - 1))];
+
+		// Readers before overwritten version can no longer be caught up
+		if (NumAppended >= Entries.Num())
+		{
+			TruncatedVersion = FMath::Max(TruncatedVersion, Entry.Version);
+		}
+
+		Entry.Version = Version;
+		Entry.Coords = Coords;
+		Entry.Value = Value;
+		NumAppended++;
+	}
+
+	/** Whether every change after given version up to current one is held */
+	FORCEINLINE bool CanReplaySince(const int32 Version, const int32 CurrentVersion) const
+	{
+		return Entries.Num() > 0 && Version >= TruncatedVersion && Version <= CurrentVersion;
+	}
+
+	/** Invokes given function with every held change after given version, oldest first */
+	template<typename FuncType>
+	void ForEachSince(const int32 Version, FuncType Func) const
+	{
+		const int64 Mask = Entries.Num() - 1;
+
+		// Walk back to first change after given version, so cost scales with number of replayed changes
+		int64 FirstIndex = NumAppended;
+		while (FirstIndex > NumAppended - Num() && Entries[(int32)((FirstIndex - 1) & Mask)].Version > Version)
+		{
+			FirstIndex--;
+		}
+
+		for (int64 Index = FirstIndex; Index < NumAppended; Index++)
+		{
+			const FMineGridMapJournalEntry& Entry = Entries[(int32)(Index & Mask)];
+			Func(Entry.Coords, Entry.Value);
+		}
+	}
+};
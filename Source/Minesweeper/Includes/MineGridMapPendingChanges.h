@@ -0,0 +1,243 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MineGridMapCell.h"
+#include "MineGridMapChanges.h"
+#include "MineGridWindow.h"
+
+#include "MineGridMapPendingChanges.generated.h"
+
+/** Kind of pending change of map area cell */
+enum class EMineGridMapPendingChange : uint8
+{
+	MGMPC_Added,
+	MGMPC_Removed,
+	MGMPC_Updated,
+};
+
+/** Pending change of map area cell along with latest value of cell, unless it is removed */
+struct FMineGridMapPendingCell
+{
+	EMineGridMapCell Value = EMineGridMapCell::MGMC_Undiscovered;
+	EMineGridMapPendingChange Change = EMineGridMapPendingChange::MGMPC_Added;
+};
+
+/**
+ * Changes of map area not yet sent out, merged so every cell ends up in at most one of added, removed or updated cells.
+ * Cell added and removed before being sent out cancels out.
+ */
+USTRUCT()
+struct FMineGridMapPendingChanges
+{
+	GENERATED_BODY()
+
+	/** Pending change of every cell, held by window following map area so merging changes of moving area hashes no coords */
+	TMineGridWindow<FMineGridMapPendingCell> PendingCells;
+
+	/** Number of pending cells leaving map area */
+	int32 NumRemovedCells = 0;
+
+	UPROPERTY()
+	FIntPoint NewGridDimensions = FIntPoint::ZeroValue;
+
+	FORCEINLINE int32 Num() const { return PendingCells.Num(); }
+
+	FORCEINLINE bool IsEmpty() const { return Num() == 0; }
+
+	void AddCell(const FIntPoint& Coords, const EMineGridMapCell Value)
+	{
+		FMineGridMapPendingCell& PendingCell = PendingCells.FindOrAdd(Coords);
+
+		// Cell removed and added back never left map area
+		if (PendingCell.Change == EMineGridMapPendingChange::MGMPC_Removed)
+		{
+			PendingCell.Change = EMineGridMapPendingChange::MGMPC_Updated;
+			NumRemovedCells--;
+		}
+		PendingCell.Value = Value;
+	}
+
+	void RemoveCell(const FIntPoint& Coords)
+	{
+		FMineGridMapPendingCell* PendingCell = PendingCells.Find(Coords);
+
+		// Cell added and removed never entered map area
+		if (PendingCell && PendingCell->Change == EMineGridMapPendingChange::MGMPC_Added)
+		{
+			PendingCells.Remove(Coords);
+			return;
+		}
+
+		if (!PendingCell)
+		{
+			PendingCell = &PendingCells.FindOrAdd(Coords);
+		}
+		else if (PendingCell->Change == EMineGridMapPendingChange::MGMPC_Removed)
+		{
+			return;
+		}
+
+		PendingCell->Change = EMineGridMapPendingChange::MGMPC_Removed;
+		NumRemovedCells++;
+	}
+
+	void UpdateCell(const FIntPoint& Coords, const EMineGridMapCell Value)
+	{
+		FMineGridMapPendingCell* PendingCell = PendingCells.Find(Coords);
+		if (!PendingCell)
+		{
+			PendingCell = &PendingCells.FindOrAdd(Coords);
+			PendingCell->Change = EMineGridMapPendingChange::MGMPC_Updated;
+		}
+
+		// Cell leaving map area is not updated anymore
+		if (PendingCell->Change != EMineGridMapPendingChange::MGMPC_Removed)
+		{
+			PendingCell->Value = Value;
+		}
+	}
+
+	void Append(const FMineGridMapChanges& GridMapChanges)
+	{
+		// Window covers twice the map area, so cells entering moving area do not alias cells it left before they are sent out
+		PendingCells.Reserve(GridMapChanges.NewGridDimensions * 2);
+
+		for (const FIntPoint& RemovedCellCoords : GridMapChanges.RemovedGridMapCells)
+		{
+			RemoveCell(RemovedCellCoords);
+		}
+
+		const int32 NumAddedCells = FMath::Min(GridMapChanges.AddedGridMapCellCoords.Num(), GridMapChanges.AddedGridMapCellValues.Num());
+		for (int32 AddedIndex = 0; AddedIndex < NumAddedCells; AddedIndex++)
+		{
+			AddCell(GridMapChanges.AddedGridMapCellCoords[AddedIndex], GridMapChanges.AddedGridMapCellValues[AddedIndex]);
+		}
+
+		NewGridDimensions = GridMapChanges.NewGridDimensions;
+	}
+
+	void Append(const FMineGridMapCellUpdates& CellUpdates)
+	{
+		const int32 NumUpdatedCells = FMath::Min(CellUpdates.UpdatedGridMapCellCoords.Num(), CellUpdates.UpdatedGridMapCellValues.Num());
+		for (int32 UpdatedIndex = 0; UpdatedIndex < NumUpdatedCells; UpdatedIndex++)
+		{
+			UpdateCell(CellUpdates.UpdatedGridMapCellCoords[UpdatedIndex], CellUpdates.UpdatedGridMapCellValues[UpdatedIndex]);
+		}
+	}
+
+	/** Moves merged changes out, leaving no pending ones */
+	void Consume(FMineGridMapChanges& OutGridMapChanges, FMineGridMapCellUpdates& OutCellUpdates)
+	{
+		OutGridMapChanges.NewGridDimensions = NewGridDimensions;
+
+		const int32 NumAddedOrUpdatedCells = Num() - NumRemovedCells;
+		OutGridMapChanges.RemovedGridMapCells.Reset(NumRemovedCells);
+		OutGridMapChanges.AddedGridMapCellCoords.Reset(NumAddedOrUpdatedCells);
+		OutGridMapChanges.AddedGridMapCellValues.Reset(NumAddedOrUpdatedCells);
+		OutCellUpdates.UpdatedGridMapCellCoords.Reset(NumAddedOrUpdatedCells);
+		OutCellUpdates.UpdatedGridMapCellValues.Reset(NumAddedOrUpdatedCells);
+
+		PendingCells.ForEach([&OutGridMapChanges, &OutCellUpdates](const FIntPoint& Coords, const FMineGridMapPendingCell& PendingCell)
+		{
+			switch (PendingCell.Change)
+			{
+			case EMineGridMapPendingChange::MGMPC_Added:
+				OutGridMapChanges.AddedGridMapCellCoords.Add(Coords);
+				OutGridMapChanges.AddedGridMapCellValues.Add(PendingCell.Value);
+				break;
+			case EMineGridMapPendingChange::MGMPC_Removed:
+				OutGridMapChanges.RemovedGridMapCells.Add(Coords);
+				break;
+			case EMineGridMapPendingChange::MGMPC_Updated:
+				OutCellUpdates.UpdatedGridMapCellCoords.Add(Coords);
+				OutCellUpdates.UpdatedGridMapCellValues.Add(PendingCell.Value);
+				break;
+			}
+		});
+
+		// Keep window for next changes
+		PendingCells.Reset();
+		NumRemovedCells = 0;
+	}
+
+	/**
+	 * Moves out every removed cell and at most given number of added and updated ones, leaving the rest pending.
+	 * Cells nearest to origin go first, cells ahead in given unit heading counting as up to half as far as they are.
+	 * Cells as near as each other go in row order.
+	 */
+	void ConsumeNearest(const FIntPoint& Origin, const FVector2D& Heading, const int32 MaxNumCells, FMineGridMapChanges& OutGridMapChanges, FMineGridMapCellUpdates& OutCellUpdates)
+	{
+		if (Num() - NumRemovedCells <= MaxNumCells)
+		{
+			Consume(OutGridMapChanges, OutCellUpdates);
+			return;
+		}
+
+		struct FPrioritizedCell
+		{
+			float Priority;
+			FIntPoint Coords;
+		};
+
+		OutGridMapChanges.NewGridDimensions = NewGridDimensions;
+		OutGridMapChanges.RemovedGridMapCells.Reset(NumRemovedCells);
+		OutGridMapChanges.AddedGridMapCellCoords.Reset();
+		OutGridMapChanges.AddedGridMapCellValues.Reset();
+		OutCellUpdates.UpdatedGridMapCellCoords.Reset();
+		OutCellUpdates.UpdatedGridMapCellValues.Reset();
+
+		TArray<FPrioritizedCell> PrioritizedCells;
+		PrioritizedCells.Reserve(Num() - NumRemovedCells);
+
+		PendingCells.ForEach([&PrioritizedCells, &OutGridMapChanges, &Origin, &Heading](const FIntPoint& Coords, const FMineGridMapPendingCell& PendingCell)
+		{
+			if (PendingCell.Change == EMineGridMapPendingChange::MGMPC_Removed)
+			{
+				OutGridMapChanges.RemovedGridMapCells.Add(Coords);
+				return;
+			}
+
+			const FVector2D Offset(Coords - Origin);
+			const float Priority = Offset.Size() - 0.5f * FMath::Max(0.f, FVector2D::DotProduct(Offset, Heading));
+			PrioritizedCells.Add({ Priority, Coords });
+		});
+
+		// Only popped cells are ordered, so cost grows with number of moved out changes rather than pending ones.
+		// Cells of equal priority go in row order, so moved out cells do not depend on order of window slots.
+		const auto ByPriority = [](const FPrioritizedCell& A, const FPrioritizedCell& B)
+		{
+			if (A.Priority != B.Priority)
+			{
+				return A.Priority < B.Priority;
+			}
+			return A.Coords.Y != B.Coords.Y ? A.Coords.Y < B.Coords.Y : A.Coords.X < B.Coords.X;
+		};
+		PrioritizedCells.Heapify(ByPriority);
+
+		for (int32 CellIndex = 0; CellIndex < MaxNumCells; CellIndex++)
+		{
+			FPrioritizedCell PrioritizedCell;
+			PrioritizedCells.HeapPop(PrioritizedCell, ByPriority, false);
+
+			FMineGridMapPendingCell PendingCell;
+			PendingCells.RemoveAndCopyValue(PrioritizedCell.Coords, PendingCell);
+
+			if (PendingCell.Change == EMineGridMapPendingChange::MGMPC_Added)
+			{
+				OutGridMapChanges.AddedGridMapCellCoords.Add(PrioritizedCell.Coords);
+				OutGridMapChanges.AddedGridMapCellValues.Add(PendingCell.Value);
+			}
+			else
+			{
+				OutCellUpdates.UpdatedGridMapCellCoords.Add(PrioritizedCell.Coords);
+				OutCellUpdates.UpdatedGridMapCellValues.Add(PendingCell.Value);
+			}
+		}
+
+		for (const FIntPoint& RemovedCellCoords : OutGridMapChanges.RemovedGridMapCells)
+		{
+			PendingCells.Remove(RemovedCellCoords);
+		}
+		NumRemovedCells = 0;
+	}
+};
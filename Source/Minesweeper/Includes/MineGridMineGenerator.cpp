@@ -0,0 +1,139 @@
+#include "MineGridMineGenerator.h"
+
+namespace MineGridMineGenerator
+{
+	static constexpr uint32 NumRounds = 4;
+
+	/** Minimal PCG32 random stream (XSH RR output of 64-bit LCG state) */
+	struct FPCG32
+	{
+		uint64 State;
+
+		explicit FPCG32(const uint64 Seed)
+			: State(0)
+		{
+			Next();
+			State += Seed;
+			Next();
+		}
+
+		FORCEINLINE uint32 Next()
+		{
+			const uint64 OldState = State;
+			State = OldState * 6364136223846793005ull + 1442695040888963407ull;
+
+			const uint32 XorShifted = (uint32)(((OldState >> 18) ^ OldState) >> 27);
+			const uint32 Rotation = (uint32)(OldState >> 59);
+			return (XorShifted >> Rotation) | (XorShifted << ((32 - Rotation) & 31));
+		}
+	};
+
+	// Finalizer of MurmurHash3, spreading every input bit over the whole word
+	FORCEINLINE uint32 Mix(uint32 Value)
+	{
+		Value ^= Value >> 16;
+		Value *= 0x85ebca6bu;
+		Value ^= Value >> 13;
+		Value *= 0xc2b2ae35u;
+		Value ^= Value >> 16;
+		return Value;
+	}
+}
+
+void FMineGridMineGenerator::Init(const FIntPoint& InGridDimensions, const int32 InSeed, const int32 InNumMines)
+{
+	GridDimensions = InGridDimensions;
+	Seed = InSeed;
+	NumPermutedMines = FMath::Clamp(InNumMines, 0, Num());
+	NumMines = NumPermutedMines;
+	bHasSafeBounds = false;
+	SafeBounds = FIntRect();
+
+	MineGridMineGenerator::FPCG32 RandomStream((uint64)(uint32)Seed);
+	for (uint32& RoundKey : RoundKeys)
+	{
+		RoundKey = RandomStream.Next();
+	}
+
+	// Smallest square power of two domain covering every cell, so index walks out of range less than four times on average
+	HalfIndexBits = 1;
+	while ((int64)1 << (HalfIndexBits * 2) < (int64)Num())
+	{
+		HalfIndexBits++;
+	}
+}
+
+void FMineGridMineGenerator::SetSafeBounds(const FIntRect& Bounds)
+{
+	bHasSafeBounds = false;
+	NumMines = NumPermutedMines;
+
+	SafeBounds.Min = FIntPoint(FMath::Max(Bounds.Min.X, 0), FMath::Max(Bounds.Min.Y, 0));
+	SafeBounds.Max = FIntPoint(FMath::Min(Bounds.Max.X, GridDimensions.X - 1), FMath::Min(Bounds.Max.Y, GridDimensions.Y - 1));
+
+	for (int32 Y = SafeBounds.Min.Y; Y <= SafeBounds.Max.Y; Y++)
+	{
+		for (int32 X = SafeBounds.Min.X; X <= SafeBounds.Max.X; X++)
+		{
+			NumMines -= (int32)IsMine(FIntPoint(X, Y));
+		}
+	}
+
+	bHasSafeBounds = true;
+}
+
+uint32 FMineGridMineGenerator::RoundHash(const uint32 Half, const uint32 Round) const
+{
+	return MineGridMineGenerator::Mix(Half ^ RoundKeys[Round]) & ((1u << HalfIndexBits) - 1);
+}
+
+uint32 FMineGridMineGenerator::PermuteIndex(uint32 Index) const
+{
+	using namespace MineGridMineGenerator;
+
+	const uint32 HalfMask = (1u << HalfIndexBits) - 1;
+
+	// Cycle-walking keeps permutation of whole domain within range of cell indices
+	do
+	{
+		uint32 Left = Index >> HalfIndexBits;
+		uint32 Right = Index & HalfMask;
+
+		for (uint32 Round = 0; Round < NumRounds; Round++)
+		{
+			const uint32 NextRight = Left ^ RoundHash(Right, Round);
+			Left = Right;
+			Right = NextRight;
+		}
+
+		Index = (Left << HalfIndexBits) | Right;
+	}
+	while (Index >= (uint32)Num());
+
+	return Index;
+}
+
+uint32 FMineGridMineGenerator::UnpermuteIndex(uint32 PermutedIndex) const
+{
+	using namespace MineGridMineGenerator;
+
+	const uint32 HalfMask = (1u << HalfIndexBits) - 1;
+
+	do
+	{
+		uint32 Left = PermutedIndex >> HalfIndexBits;
+		uint32 Right = PermutedIndex & HalfMask;
+
+		for (uint32 Round = NumRounds; Round-- > 0;)
+		{
+			const uint32 PrevLeft = Right ^ RoundHash(Left, Round);
+			Right = Left;
+			Left = PrevLeft;
+		}
+
+		PermutedIndex = (Left << HalfIndexBits) | Right;
+	}
+	while (PermutedIndex >= (uint32)Num());
+
+	return PermutedIndex;
+}
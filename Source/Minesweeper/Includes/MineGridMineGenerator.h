@@ -0,0 +1,93 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "MineGridMineGenerator.generated.h"
+
+/**
+ * Stateless mines layout derived from seed. Cell indices are shuffled by seeded permutation and cells whose
+ * permuted index falls below number of mines hold one, so layout has exact number of mines while every cell
+ * is answered on its own in constant time. Coordinates are relative to first cell of map.
+ */
+USTRUCT(BlueprintType)
+struct MINESWEEPER_API FMineGridMineGenerator
+{
+	GENERATED_BODY()
+
+	/** Seed the layout is derived from */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Seed = 0;
+
+	/** Represents size of mines layout */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FIntPoint GridDimensions = FIntPoint::ZeroValue;
+
+	/** Number of mines of layout, not counting ones dropped from safe bounds */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumMines = 0;
+
+	/** Number of permuted cell indices holding mines */
+	UPROPERTY()
+	int32 NumPermutedMines = 0;
+
+	/** Number of bits of each half of permuted index */
+	UPROPERTY()
+	int32 HalfIndexBits = 0;
+
+	/** Keys of Feistel rounds, drawn from seeded random stream */
+	UPROPERTY()
+	uint32 RoundKeys[4] = {};
+
+	/** Mine-free bounds (end-inclusive), valid only if bHasSafeBounds is set. Not a property, FIntRect having no reflection */
+	FIntRect SafeBounds;
+
+	UPROPERTY()
+	bool bHasSafeBounds = false;
+
+	/** Sets up layout of given number of mines, clamped to number of cells */
+	void Init(const FIntPoint& InGridDimensions, const int32 InSeed, const int32 InNumMines);
+
+	/** Drops mines inside of given bounds (end-inclusive), keeping the rest of layout as it is */
+	void SetSafeBounds(const FIntRect& Bounds);
+
+	FORCEINLINE int32 Num() const { return GridDimensions.X * GridDimensions.Y; }
+
+	FORCEINLINE bool IsInSafeBounds(const FIntPoint& Coords) const
+	{
+		return bHasSafeBounds
+			&& Coords.X >= SafeBounds.Min.X && Coords.X <= SafeBounds.Max.X
+			&& Coords.Y >= SafeBounds.Min.Y && Coords.Y <= SafeBounds.Max.Y;
+	}
+
+	FORCEINLINE bool IsMine(const FIntPoint& Coords) const
+	{
+		return (int32)PermuteIndex((uint32)(Coords.Y * GridDimensions.X + Coords.X)) < NumPermutedMines && !IsInSafeBounds(Coords);
+	}
+
+	/** Invokes given function with coords of every mine, taking time proportional to number of mines rather than cells */
+	template<typename FuncType>
+	void ForEachMine(FuncType Func) const
+	{
+		for (int32 PermutedIndex = 0; PermutedIndex < NumPermutedMines; PermutedIndex++)
+		{
+			const int32 CellIndex = (int32)UnpermuteIndex((uint32)PermutedIndex);
+			const FIntPoint Coords(CellIndex % GridDimensions.X, CellIndex / GridDimensions.X);
+
+			if (!IsInSafeBounds(Coords))
+			{
+				Func(Coords);
+			}
+		}
+	}
+
+	/** Maps cell index to its permuted index, both being lower than number of cells */
+	uint32 PermuteIndex(uint32 Index) const;
+
+	/** Maps permuted index back to cell index */
+	uint32 UnpermuteIndex(uint32 PermutedIndex) const;
+
+private:
+
+	/** Keyed round function of Feistel network, mixing half of index */
+	uint32 RoundHash(const uint32 Half, const uint32 Round) const;
+};
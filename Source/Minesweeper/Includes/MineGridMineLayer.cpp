@@ -0,0 +1,280 @@
+#include "MineGridMineLayer.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformAtomics.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#endif
+
+namespace MineGridMineLayer
+{
+	// Neighbour planes of a row: north, north-west, north-east, west, east, south, south-west, south-east
+	static constexpr int32 NumNeighbourPlanes = 8;
+
+	// Count planes of a row: bits of weight 1, 2, 4 and 8
+	static constexpr int32 NumCountPlanes = 4;
+
+	// Number of rows processed by one parallel task
+	static constexpr int32 RowsPerBand = 32;
+
+	// Number of mines placed by one parallel task of materialization
+	static constexpr int32 MinesPerChunk = 4096;
+
+	struct FScalarWordOps
+	{
+		typedef uint64 Type;
+		static constexpr int32 Lanes = 1;
+
+		static FORCEINLINE Type Load(const uint64* Ptr) { return *Ptr; }
+		static FORCEINLINE void Store(uint64* Ptr, Type Value) { *Ptr = Value; }
+		static FORCEINLINE Type And(Type A, Type B) { return A & B; }
+		static FORCEINLINE Type Or(Type A, Type B) { return A | B; }
+		static FORCEINLINE Type Xor(Type A, Type B) { return A ^ B; }
+	};
+
+#if PLATFORM_CPU_X86_FAMILY
+	struct FSSE2WordOps
+	{
+		typedef __m128i Type;
+		static constexpr int32 Lanes = 2;
+
+		static FORCEINLINE Type Load(const uint64* Ptr) { return _mm_loadu_si128((const __m128i*)Ptr); }
+		static FORCEINLINE void Store(uint64* Ptr, Type Value) { _mm_storeu_si128((__m128i*)Ptr, Value); }
+		static FORCEINLINE Type And(Type A, Type B) { return _mm_and_si128(A, B); }
+		static FORCEINLINE Type Or(Type A, Type B) { return _mm_or_si128(A, B); }
+		static FORCEINLINE Type Xor(Type A, Type B) { return _mm_xor_si128(A, B); }
+	};
+
+#if defined(__AVX2__)
+	struct FAVX2WordOps
+	{
+		typedef __m256i Type;
+		static constexpr int32 Lanes = 4;
+
+		static FORCEINLINE Type Load(const uint64* Ptr) { return _mm256_loadu_si256((const __m256i*)Ptr); }
+		static FORCEINLINE void Store(uint64* Ptr, Type Value) { _mm256_storeu_si256((__m256i*)Ptr, Value); }
+		static FORCEINLINE Type And(Type A, Type B) { return _mm256_and_si256(A, B); }
+		static FORCEINLINE Type Or(Type A, Type B) { return _mm256_or_si256(A, B); }
+		static FORCEINLINE Type Xor(Type A, Type B) { return _mm256_xor_si256(A, B); }
+	};
+#endif
+#endif
+
+	template<typename WordOps>
+	FORCEINLINE void FullAdd(typename WordOps::Type A, typename WordOps::Type B, typename WordOps::Type C,
+		typename WordOps::Type& OutSum, typename WordOps::Type& OutCarry)
+	{
+		const typename WordOps::Type AB = WordOps::Xor(A, B);
+		OutSum = WordOps::Xor(AB, C);
+		OutCarry = WordOps::Or(WordOps::And(A, B), WordOps::And(C, AB));
+	}
+
+	/**
+	 * Bit-sliced addition of eight neighbour planes into four count planes, starting at given word.
+	 * Every vector kernel evaluates the same boolean network, so results do not depend on which one ran.
+	 * Returns index of first word left unprocessed.
+	 */
+	template<typename WordOps>
+	int32 SumNeighbourPlanes(const uint64* const* Planes, uint64* const* Counts, int32 Word, const int32 NumWords)
+	{
+		typedef typename WordOps::Type FWord;
+
+		for (; Word + WordOps::Lanes <= NumWords; Word += WordOps::Lanes)
+		{
+			FWord NorthSum, NorthCarry, SouthSum, SouthCarry;
+			FullAdd<WordOps>(WordOps::Load(Planes[0] + Word), WordOps::Load(Planes[1] + Word), WordOps::Load(Planes[2] + Word), NorthSum, NorthCarry);
+			FullAdd<WordOps>(WordOps::Load(Planes[5] + Word), WordOps::Load(Planes[6] + Word), WordOps::Load(Planes[7] + Word), SouthSum, SouthCarry);
+
+			const FWord West = WordOps::Load(Planes[3] + Word);
+			const FWord East = WordOps::Load(Planes[4] + Word);
+			const FWord SidesSum = WordOps::Xor(West, East);
+			const FWord SidesCarry = WordOps::And(West, East);
+
+			// Weight 1 bits
+			FWord Ones, OnesCarry;
+			FullAdd<WordOps>(NorthSum, SouthSum, SidesSum, Ones, OnesCarry);
+
+			// Weight 2 bits
+			FWord TwosSum, TwosCarry;
+			FullAdd<WordOps>(NorthCarry, SouthCarry, SidesCarry, TwosSum, TwosCarry);
+			const FWord Twos = WordOps::Xor(TwosSum, OnesCarry);
+			const FWord TwosOverflow = WordOps::And(TwosSum, OnesCarry);
+
+			// Weight 4 and 8 bits
+			const FWord Fours = WordOps::Xor(TwosCarry, TwosOverflow);
+			const FWord Eights = WordOps::And(TwosCarry, TwosOverflow);
+
+			WordOps::Store(Counts[0] + Word, Ones);
+			WordOps::Store(Counts[1] + Word, Twos);
+			WordOps::Store(Counts[2] + Word, Fours);
+			WordOps::Store(Counts[3] + Word, Eights);
+		}
+
+		return Word;
+	}
+}
+
+void FMineGridMineLayer::Init(const FIntPoint& InGridDimensions)
+{
+	GridDimensions = InGridDimensions;
+	WordsPerRow = (GridDimensions.X + 63) / 64;
+	RowStride = Align(GridDimensions.X, 2);
+	NumMines = 0;
+
+	MineRows.Reset();
+	MineRows.SetNumZeroed(WordsPerRow * GridDimensions.Y);
+
+	AdjacentMineCounts.Empty();
+	Generator = FMineGridMineGenerator();
+}
+
+void FMineGridMineLayer::InitProcedural(const FMineGridMineGenerator& InGenerator)
+{
+	Generator = InGenerator;
+	GridDimensions = Generator.GridDimensions;
+	WordsPerRow = (GridDimensions.X + 63) / 64;
+	RowStride = Align(GridDimensions.X, 2);
+	NumMines = Generator.NumMines;
+
+	MineRows.Empty();
+	AdjacentMineCounts.Empty();
+}
+
+void FMineGridMineLayer::SetSafeBounds(const FIntRect& Bounds)
+{
+	Generator.SetSafeBounds(Bounds);
+	NumMines = Generator.NumMines;
+}
+
+void FMineGridMineLayer::Materialize()
+{
+	using namespace MineGridMineLayer;
+
+	MineRows.Reset();
+	MineRows.SetNumZeroed(WordsPerRow * GridDimensions.Y);
+
+	// Permuted indices of mines are split into chunks, every chunk placing its own mines only, so work follows number
+	// of mines rather than cells. Words shared by chunks are set atomically, so result does not depend on scheduling.
+	const int32 NumChunks = FMath::DivideAndRoundUp(Generator.NumPermutedMines, MinesPerChunk);
+	TArray<int32> ChunkNumMines;
+	ChunkNumMines.SetNumZeroed(NumChunks);
+
+	ParallelFor(NumChunks, [this, &ChunkNumMines](const int32 Chunk)
+	{
+		const int32 EndPermutedIndex = FMath::Min((Chunk + 1) * MinesPerChunk, Generator.NumPermutedMines);
+		int32 NumChunkMines = 0;
+
+		for (int32 PermutedIndex = Chunk * MinesPerChunk; PermutedIndex < EndPermutedIndex; PermutedIndex++)
+		{
+			const int32 CellIndex = (int32)Generator.UnpermuteIndex((uint32)PermutedIndex);
+			const FIntPoint Coords(CellIndex % GridDimensions.X, CellIndex / GridDimensions.X);
+
+			if (!Generator.IsInSafeBounds(Coords))
+			{
+				volatile int64* Word = (volatile int64*)(MineRows.GetData() + Coords.Y * WordsPerRow + (Coords.X >> 6));
+				FPlatformAtomics::InterlockedOr(Word, (int64)(1ull << (Coords.X & 63)));
+				NumChunkMines++;
+			}
+		}
+
+		ChunkNumMines[Chunk] = NumChunkMines;
+	});
+
+	NumMines = 0;
+	for (const int32 NumChunkMines : ChunkNumMines)
+	{
+		NumMines += NumChunkMines;
+	}
+}
+
+void FMineGridMineLayer::ComputeAdjacentMineCounts(const bool bAllowVectorKernel)
+{
+	using namespace MineGridMineLayer;
+
+	AdjacentMineCounts.SetNumUninitialized(RowStride * GridDimensions.Y);
+
+	// Bands of rows are counted in parallel, each one only reading mine rows and writing counts of its own rows
+	const int32 NumBands = FMath::DivideAndRoundUp(GridDimensions.Y, RowsPerBand);
+
+	ParallelFor(NumBands, [this, bAllowVectorKernel](const int32 Band)
+	{
+		ComputeAdjacentMineCountsOfRows(Band * RowsPerBand, FMath::Min((Band + 1) * RowsPerBand, GridDimensions.Y), bAllowVectorKernel);
+	});
+}
+
+void FMineGridMineLayer::ComputeAdjacentMineCountsOfRows(const int32 StartY, const int32 EndY, const bool bAllowVectorKernel)
+{
+	using namespace MineGridMineLayer;
+
+	// Scratch rows: zero row, west and east shifted rows of every neighbouring row and count planes
+	TArray<uint64> Scratch;
+	Scratch.SetNumZeroed(WordsPerRow * (1 + 6 + NumCountPlanes));
+
+	const uint64* ZeroRow = Scratch.GetData();
+	uint64* ShiftedRows = Scratch.GetData() + WordsPerRow;
+	uint64* Counts[NumCountPlanes];
+	for (int32 PlaneIndex = 0; PlaneIndex < NumCountPlanes; PlaneIndex++)
+	{
+		Counts[PlaneIndex] = Scratch.GetData() + WordsPerRow * (7 + PlaneIndex);
+	}
+
+	// Builds planes having neighbour bit to the west and to the east of each cell
+	auto ShiftRow = [this](const uint64* Row, uint64* OutWest, uint64* OutEast)
+	{
+		for (int32 Word = 0; Word < WordsPerRow; Word++)
+		{
+			OutWest[Word] = (Row[Word] << 1) | (Word > 0 ? Row[Word - 1] >> 63 : 0);
+			OutEast[Word] = (Row[Word] >> 1) | (Word + 1 < WordsPerRow ? Row[Word + 1] << 63 : 0);
+		}
+	};
+
+	for (int32 Y = StartY; Y < EndY; Y++)
+	{
+		const uint64* NorthRow = Y > 0 ? MineRows.GetData() + (Y - 1) * WordsPerRow : ZeroRow;
+		const uint64* MiddleRow = MineRows.GetData() + Y * WordsPerRow;
+		const uint64* SouthRow = Y + 1 < GridDimensions.Y ? MineRows.GetData() + (Y + 1) * WordsPerRow : ZeroRow;
+
+		uint64* Shifted[6];
+		for (int32 ShiftedIndex = 0; ShiftedIndex < 6; ShiftedIndex++)
+		{
+			Shifted[ShiftedIndex] = ShiftedRows + ShiftedIndex * WordsPerRow;
+		}
+		ShiftRow(NorthRow, Shifted[0], Shifted[1]);
+		ShiftRow(MiddleRow, Shifted[2], Shifted[3]);
+		ShiftRow(SouthRow, Shifted[4], Shifted[5]);
+
+		const uint64* const Planes[NumNeighbourPlanes] = {
+			NorthRow, Shifted[0], Shifted[1],
+			Shifted[2], Shifted[3],
+			SouthRow, Shifted[4], Shifted[5]
+		};
+
+		int32 Word = 0;
+		if (bAllowVectorKernel)
+		{
+#if PLATFORM_CPU_X86_FAMILY
+#if defined(__AVX2__)
+			Word = SumNeighbourPlanes<FAVX2WordOps>(Planes, Counts, Word, WordsPerRow);
+#endif
+			Word = SumNeighbourPlanes<FSSE2WordOps>(Planes, Counts, Word, WordsPerRow);
+#endif
+		}
+		SumNeighbourPlanes<FScalarWordOps>(Planes, Counts, Word, WordsPerRow);
+
+		// Unpack bit planes into per-cell counts
+		uint8* RowCounts = AdjacentMineCounts.GetData() + Y * RowStride;
+		for (int32 X = 0; X < GridDimensions.X; X++)
+		{
+			const int32 WordIndex = X >> 6;
+			const int32 Bit = X & 63;
+
+			RowCounts[X] = (uint8)(((Counts[0][WordIndex] >> Bit) & 1)
+				| (((Counts[1][WordIndex] >> Bit) & 1) << 1)
+				| (((Counts[2][WordIndex] >> Bit) & 1) << 2)
+				| (((Counts[3][WordIndex] >> Bit) & 1) << 3));
+		}
+	}
+}
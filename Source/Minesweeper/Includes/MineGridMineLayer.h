@@ -0,0 +1,166 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MineGridMineGenerator.h"
+
+#include "MineGridMineLayer.generated.h"
+
+/**
+ * Holds mines layout of grid map as row bitboard together with precomputed number of surrounding mines of every cell.
+ * Procedural layout may instead be left unmaterialized, answering every cell from its generator.
+ * Coordinates are relative to first cell of map.
+ */
+USTRUCT(BlueprintType)
+struct MINESWEEPER_API FMineGridMineLayer
+{
+	GENERATED_BODY()
+
+	/** Mine bits of every row, where bit N of row word M represents column M * 64 + N */
+	UPROPERTY()
+	TArray<uint64> MineRows;
+
+	/** Number of surrounding mines of every cell, indexed the same way as dense grid map. Empty unless computed. */
+	UPROPERTY()
+	TArray<uint8> AdjacentMineCounts;
+
+	/** Represents size of mines layout */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FIntPoint GridDimensions = FIntPoint::ZeroValue;
+
+	/** Number of placed mines */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 NumMines = 0;
+
+	/** Number of bitboard words per row */
+	UPROPERTY()
+	int32 WordsPerRow = 0;
+
+	/** Number of adjacent mine counts per row, including padding */
+	UPROPERTY()
+	int32 RowStride = 0;
+
+	/** Procedural layout answering cells while bitboard is not materialized */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FMineGridMineGenerator Generator;
+
+	/** Clears layout and resizes it to given dimensions */
+	void Init(const FIntPoint& InGridDimensions);
+
+	/** Takes layout of given generator without materializing it */
+	void InitProcedural(const FMineGridMineGenerator& InGenerator);
+
+	/** Drops mines of procedural layout inside of given bounds (end-inclusive). Must precede materialization. */
+	void SetSafeBounds(const FIntRect& Bounds);
+
+	/** Writes mines of procedural layout into bitboard, chunks of its mines in parallel */
+	void Materialize();
+
+	FORCEINLINE bool IsMaterialized() const { return MineRows.Num() > 0; }
+
+	/**
+	 * Computes adjacent mine counts plane of whole layout in one pass. Vector kernel is used when allowed and available,
+	 * producing the same counts as scalar one.
+	 */
+	void ComputeAdjacentMineCounts(const bool bAllowVectorKernel = true);
+
+	/** Computes adjacent mine counts of rows from StartY up to EndY exclusive, count plane being already allocated */
+	void ComputeAdjacentMineCountsOfRows(const int32 StartY, const int32 EndY, const bool bAllowVectorKernel);
+
+	FORCEINLINE bool IsMine(const FIntPoint& Coords) const
+	{
+		return IsMaterialized() ? (MineRows[Coords.Y * WordsPerRow + (Coords.X >> 6)] >> (Coords.X & 63)) & 1 : Generator.IsMine(Coords);
+	}
+
+	FORCEINLINE void SetMine(const FIntPoint& Coords)
+	{
+		uint64& Word = MineRows[Coords.Y * WordsPerRow + (Coords.X >> 6)];
+		const uint64 Mask = 1ull << (Coords.X & 63);
+
+		if (!(Word & Mask))
+		{
+			Word |= Mask;
+			NumMines++;
+		}
+	}
+
+	FORCEINLINE bool HasAdjacentMineCounts() const { return AdjacentMineCounts.Num() > 0; }
+
+	/** Number of surrounding mines, read from precomputed plane if there is one or counted otherwise */
+	FORCEINLINE uint8 GetAdjacentMineCount(const FIntPoint& Coords) const
+	{
+		return HasAdjacentMineCounts() ? AdjacentMineCounts[Coords.Y * RowStride + Coords.X] : CountAdjacentMines(Coords);
+	}
+
+	uint8 CountAdjacentMines(const FIntPoint& Coords) const
+	{
+		uint8 MinesCount = 0;
+		for (int32 Y = FMath::Max(Coords.Y - 1, 0); Y <= FMath::Min(Coords.Y + 1, GridDimensions.Y - 1); Y++)
+		{
+			for (int32 X = FMath::Max(Coords.X - 1, 0); X <= FMath::Min(Coords.X + 1, GridDimensions.X - 1); X++)
+			{
+				MinesCount += (uint8)IsMine(FIntPoint(X, Y));
+			}
+		}
+		return MinesCount - (uint8)IsMine(Coords);
+	}
+
+	FORCEINLINE uint8 GetAdjacentMineCountAt(const int32 Index) const
+	{
+		return AdjacentMineCounts[Index];
+	}
+
+	/** Invokes given function with coords of every mine inside of rect (end-inclusive), row by row */
+	template<typename FuncType>
+	void ForEachMineInRect(const FIntRect& Rect, FuncType Func) const
+	{
+		const int32 MinX = FMath::Max(Rect.Min.X, 0);
+		const int32 MaxX = FMath::Min(Rect.Max.X, GridDimensions.X - 1);
+
+		for (int32 Y = FMath::Max(Rect.Min.Y, 0); Y <= FMath::Min(Rect.Max.Y, GridDimensions.Y - 1); Y++)
+		{
+			if (!IsMaterialized())
+			{
+				for (int32 X = MinX; X <= MaxX; X++)
+				{
+					if (Generator.IsMine(FIntPoint(X, Y)))
+					{
+						Func(FIntPoint(X, Y));
+					}
+				}
+				continue;
+			}
+
+			const uint64* Row = MineRows.GetData() + Y * WordsPerRow;
+			for (int32 X = MinX; X <= MaxX; X++)
+			{
+				if ((Row[X >> 6] >> (X & 63)) & 1)
+				{
+					Func(FIntPoint(X, Y));
+				}
+			}
+		}
+	}
+
+	/** Invokes given function with coords of every mine, row by row unless layout is not materialized */
+	template<typename FuncType>
+	void ForEachMine(FuncType Func) const
+	{
+		if (!IsMaterialized())
+		{
+			Generator.ForEachMine(Func);
+			return;
+		}
+
+		for (int32 Y = 0; Y < GridDimensions.Y; Y++)
+		{
+			const uint64* Row = MineRows.GetData() + Y * WordsPerRow;
+			for (int32 WordIndex = 0; WordIndex < WordsPerRow; WordIndex++)
+			{
+				for (uint64 Word = Row[WordIndex]; Word != 0; Word &= Word - 1)
+				{
+					Func(FIntPoint(WordIndex * 64 + (int32)FMath::CountTrailingZeros64(Word), Y));
+				}
+			}
+		}
+	}
+};
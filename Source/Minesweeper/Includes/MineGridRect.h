@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Integer operations on end-inclusive rects of grid cells, empty rects having Min greater than Max on some axis.
+ */
+namespace MineGridRect
+{
+	FORCEINLINE bool IsEmpty(const FIntRect& Rect)
+	{
+		return Rect.Min.X > Rect.Max.X || Rect.Min.Y > Rect.Max.Y;
+	}
+
+	FORCEINLINE int32 NumCells(const FIntRect& Rect)
+	{
+		return IsEmpty(Rect) ? 0 : (Rect.Max.X - Rect.Min.X + 1) * (Rect.Max.Y - Rect.Min.Y + 1);
+	}
+
+	FORCEINLINE bool Contains(const FIntRect& Rect, const FIntPoint& Coords)
+	{
+		return Coords.X >= Rect.Min.X && Coords.X <= Rect.Max.X
+			&& Coords.Y >= Rect.Min.Y && Coords.Y <= Rect.Max.Y;
+	}
+
+	FORCEINLINE bool Intersects(const FIntRect& Rect, const FIntRect& OtherRect)
+	{
+		return Rect.Min.X <= OtherRect.Max.X && OtherRect.Min.X <= Rect.Max.X
+			&& Rect.Min.Y <= OtherRect.Max.Y && OtherRect.Min.Y <= Rect.Max.Y;
+	}
+
+	/** Cells in both rects, empty if they do not intersect */
+	FORCEINLINE FIntRect Intersection(const FIntRect& Rect, const FIntRect& OtherRect)
+	{
+		return FIntRect(
+			FIntPoint(FMath::Max(Rect.Min.X, OtherRect.Min.X), FMath::Max(Rect.Min.Y, OtherRect.Min.Y)),
+			FIntPoint(FMath::Min(Rect.Max.X, OtherRect.Max.X), FMath::Min(Rect.Max.Y, OtherRect.Max.Y))
+		);
+	}
+
+	/** Smallest rect covering both rects, ignoring empty ones */
+	FORCEINLINE FIntRect Bounds(const FIntRect& Rect, const FIntRect& OtherRect)
+	{
+		if (IsEmpty(Rect))
+		{
+			return OtherRect;
+		}
+		if (IsEmpty(OtherRect))
+		{
+			return Rect;
+		}
+
+		return FIntRect(
+			FIntPoint(FMath::Min(Rect.Min.X, OtherRect.Min.X), FMath::Min(Rect.Min.Y, OtherRect.Min.Y)),
+			FIntPoint(FMath::Max(Rect.Max.X, OtherRect.Max.X), FMath::Max(Rect.Max.Y, OtherRect.Max.Y))
+		);
+	}
+
+	/**
+	 * Appends up to four disjoint rects covering cells of rect outside of subtracted rect: full-width bands above and below it,
+	 * then left and right parts of rows it spans.
+	 */
+	inline void Difference(const FIntRect& Rect, const FIntRect& SubtractedRect, TArray<FIntRect>& OutRects)
+	{
+		if (IsEmpty(Rect))
+		{
+			return;
+		}
+
+		if (IsEmpty(SubtractedRect) || !Intersects(Rect, SubtractedRect))
+		{
+			OutRects.Add(Rect);
+			return;
+		}
+
+		const int32 MiddleMinY = FMath::Max(Rect.Min.Y, SubtractedRect.Min.Y);
+		const int32 MiddleMaxY = FMath::Min(Rect.Max.Y, SubtractedRect.Max.Y);
+
+		if (Rect.Min.Y < MiddleMinY)
+		{
+			OutRects.Emplace(Rect.Min, FIntPoint(Rect.Max.X, MiddleMinY - 1));
+		}
+		if (MiddleMaxY < Rect.Max.Y)
+		{
+			OutRects.Emplace(FIntPoint(Rect.Min.X, MiddleMaxY + 1), Rect.Max);
+		}
+		if (Rect.Min.X < SubtractedRect.Min.X)
+		{
+			OutRects.Emplace(FIntPoint(Rect.Min.X, MiddleMinY), FIntPoint(SubtractedRect.Min.X - 1, MiddleMaxY));
+		}
+		if (SubtractedRect.Max.X < Rect.Max.X)
+		{
+			OutRects.Emplace(FIntPoint(SubtractedRect.Max.X + 1, MiddleMinY), FIntPoint(Rect.Max.X, MiddleMaxY));
+		}
+	}
+}
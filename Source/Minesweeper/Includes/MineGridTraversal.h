@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Traversal of grid cells by locations in cell units, that is relative to grid origin and divided by cell size.
+ */
+namespace MineGridTraversal
+{
+	FORCEINLINE FIntPoint GetCellCoords(const FVector2D& Location)
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X), FMath::FloorToInt(Location.Y));
+	}
+
+	/**
+	 * Invokes given function with every cell segment between given locations passes through, in order, excluding cell
+	 * of start location. Segment passing exactly through cell corner visits one of cells sharing it, so no cell is skipped.
+	 */
+	template<typename FuncType>
+	void ForEachCellOnSegment(const FVector2D& Start, const FVector2D& End, FuncType Func)
+	{
+		FIntPoint Coords = GetCellCoords(Start);
+		const FIntPoint EndCoords = GetCellCoords(End);
+
+		const FVector2D Delta = End - Start;
+		const FIntPoint Step(Delta.X > 0.f ? 1 : -1, Delta.Y > 0.f ? 1 : -1);
+
+		// Fraction of segment at which it crosses next column and row border, and fraction between consecutive borders
+		float NextBorderX = MAX_flt;
+		float BorderDistanceX = MAX_flt;
+		if (Delta.X != 0.f)
+		{
+			NextBorderX = ((Step.X > 0 ? Coords.X + 1 : Coords.X) - Start.X) / Delta.X;
+			BorderDistanceX = FMath::Abs(1.f / Delta.X);
+		}
+
+		float NextBorderY = MAX_flt;
+		float BorderDistanceY = MAX_flt;
+		if (Delta.Y != 0.f)
+		{
+			NextBorderY = ((Step.Y > 0 ? Coords.Y + 1 : Coords.Y) - Start.Y) / Delta.Y;
+			BorderDistanceY = FMath::Abs(1.f / Delta.Y);
+		}
+
+		// Every crossed border moves by one column or row, so number of steps is known up front
+		// and traversal ends at cell of end location regardless of rounding
+		int32 NumStepsX = FMath::Abs(EndCoords.X - Coords.X);
+		int32 NumStepsY = FMath::Abs(EndCoords.Y - Coords.Y);
+
+		while (NumStepsX > 0 || NumStepsY > 0)
+		{
+			if (NumStepsY == 0 || (NumStepsX > 0 && NextBorderX < NextBorderY))
+			{
+				Coords.X += Step.X;
+				NextBorderX += BorderDistanceX;
+				NumStepsX--;
+			}
+			else
+			{
+				Coords.Y += Step.Y;
+				NextBorderY += BorderDistanceY;
+				NumStepsY--;
+			}
+
+			Func(Coords);
+		}
+	}
+}
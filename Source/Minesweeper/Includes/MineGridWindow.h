@@ -0,0 +1,220 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Toroidal window of values keyed by coords, indexed by coords modulo its power-of-two dimensions.
+ * As long as held coords fit into window, values following moving map area are looked up by array indexing
+ * and shifting it only reuses slots of wrapped edge rows and columns. Values of coords aliasing held ones,
+ * as of several map areas far apart, go to overflow map.
+ */
+template<typename ValueType>
+struct TMineGridWindow
+{
+	struct FSlot
+	{
+		FIntPoint Coords = FIntPoint::ZeroValue;
+		ValueType Value = ValueType();
+		bool bIsUsed = false;
+	};
+
+	/** Slots in row-major order, both dimensions being power of two */
+	TArray<FSlot> Slots;
+
+	FIntPoint Dimensions = FIntPoint::ZeroValue;
+
+	/** Values of coords aliasing used window slots */
+	TMap<FIntPoint, ValueType> OverflowValues;
+
+	/** Grows window to hold at least given dimensions, moving held values into it */
+	void Reserve(const FIntPoint& MinDimensions)
+	{
+		const FIntPoint NewDimensions(
+			FMath::RoundUpToPowerOfTwo(FMath::Max(MinDimensions.X, 1)),
+			FMath::RoundUpToPowerOfTwo(FMath::Max(MinDimensions.Y, 1))
+		);
+
+		if (NewDimensions.X <= Dimensions.X && NewDimensions.Y <= Dimensions.Y)
+		{
+			return;
+		}
+
+		TArray<TPair<FIntPoint, ValueType>> HeldValues;
+		HeldValues.Reserve(Num());
+		ForEach([&HeldValues](const FIntPoint& Coords, const ValueType& Value) { HeldValues.Emplace(Coords, Value); });
+
+		Dimensions = FIntPoint(FMath::Max(NewDimensions.X, Dimensions.X), FMath::Max(NewDimensions.Y, Dimensions.Y));
+		Slots.Reset();
+		Slots.SetNum(Dimensions.X * Dimensions.Y);
+		NumUsedSlots = 0;
+		OverflowValues.Reset();
+
+		for (const TPair<FIntPoint, ValueType>& HeldValue : HeldValues)
+		{
+			Add(HeldValue.Key, HeldValue.Value);
+		}
+	}
+
+	FORCEINLINE int32 Num() const { return NumUsedSlots + OverflowValues.Num(); }
+
+	FORCEINLINE ValueType* Find(const FIntPoint& Coords)
+	{
+		return const_cast<ValueType*>(static_cast<const TMineGridWindow*>(this)->Find(Coords));
+	}
+
+	FORCEINLINE const ValueType* Find(const FIntPoint& Coords) const
+	{
+		if (Slots.Num() > 0)
+		{
+			const FSlot& Slot = Slots[GetSlotIndex(Coords)];
+			if (Slot.bIsUsed && Slot.Coords == Coords)
+			{
+				return &Slot.Value;
+			}
+		}
+
+		return OverflowValues.Num() > 0 ? OverflowValues.Find(Coords) : nullptr;
+	}
+
+	FORCEINLINE ValueType& FindChecked(const FIntPoint& Coords)
+	{
+		ValueType* Value = Find(Coords);
+		check(Value);
+		return *Value;
+	}
+
+	FORCEINLINE const ValueType& FindChecked(const FIntPoint& Coords) const
+	{
+		const ValueType* Value = Find(Coords);
+		check(Value);
+		return *Value;
+	}
+
+	FORCEINLINE bool Contains(const FIntPoint& Coords) const { return Find(Coords) != nullptr; }
+
+	/** Coords whose value holds window slot of given coords, if any */
+	FORCEINLINE bool FindSlotCoords(const FIntPoint& Coords, FIntPoint& OutSlotCoords) const
+	{
+		if (Slots.Num() > 0 && Slots[GetSlotIndex(Coords)].bIsUsed)
+		{
+			OutSlotCoords = Slots[GetSlotIndex(Coords)].Coords;
+			return true;
+		}
+		return false;
+	}
+
+	/** Value at given coords, default one being added if there is none yet */
+	ValueType& FindOrAdd(const FIntPoint& Coords)
+	{
+		if (ValueType* ExistingValue = Find(Coords))
+		{
+			return *ExistingValue;
+		}
+
+		if (Slots.Num() > 0)
+		{
+			FSlot& Slot = Slots[GetSlotIndex(Coords)];
+			if (!Slot.bIsUsed)
+			{
+				Slot.Coords = Coords;
+				Slot.Value = ValueType();
+				Slot.bIsUsed = true;
+				NumUsedSlots++;
+				return Slot.Value;
+			}
+		}
+
+		return OverflowValues.Add(Coords);
+	}
+
+	FORCEINLINE void Add(const FIntPoint& Coords, const ValueType& Value) { FindOrAdd(Coords) = Value; }
+
+	bool RemoveAndCopyValue(const FIntPoint& Coords, ValueType& OutValue)
+	{
+		if (Slots.Num() > 0)
+		{
+			FSlot& Slot = Slots[GetSlotIndex(Coords)];
+			if (Slot.bIsUsed && Slot.Coords == Coords)
+			{
+				OutValue = Slot.Value;
+				Slot.bIsUsed = false;
+				NumUsedSlots--;
+				return true;
+			}
+		}
+
+		return OverflowValues.Num() > 0 && OverflowValues.RemoveAndCopyValue(Coords, OutValue);
+	}
+
+	FORCEINLINE bool Remove(const FIntPoint& Coords)
+	{
+		ValueType RemovedValue;
+		return RemoveAndCopyValue(Coords, RemovedValue);
+	}
+
+	/** Drops every value, keeping window allocated */
+	void Reset()
+	{
+		if (NumUsedSlots > 0)
+		{
+			for (FSlot& Slot : Slots)
+			{
+				Slot.bIsUsed = false;
+			}
+			NumUsedSlots = 0;
+		}
+		OverflowValues.Reset();
+	}
+
+	/** Invokes given function with coords and value of every held value, window slots in row-major order first */
+	template<typename FuncType>
+	void ForEach(FuncType Func) const
+	{
+		if (NumUsedSlots > 0)
+		{
+			for (const FSlot& Slot : Slots)
+			{
+				if (Slot.bIsUsed)
+				{
+					Func(Slot.Coords, Slot.Value);
+				}
+			}
+		}
+
+		for (const TPair<FIntPoint, ValueType>& OverflowValue : OverflowValues)
+		{
+			Func(OverflowValue.Key, OverflowValue.Value);
+		}
+	}
+
+	/** Invokes given function with coords and mutable value of every held value */
+	template<typename FuncType>
+	void ForEach(FuncType Func)
+	{
+		if (NumUsedSlots > 0)
+		{
+			for (FSlot& Slot : Slots)
+			{
+				if (Slot.bIsUsed)
+				{
+					Func(Slot.Coords, Slot.Value);
+				}
+			}
+		}
+
+		for (TPair<FIntPoint, ValueType>& OverflowValue : OverflowValues)
+		{
+			Func(OverflowValue.Key, OverflowValue.Value);
+		}
+	}
+
+private:
+
+	int32 NumUsedSlots = 0;
+
+	/** Coords modulo dimensions, masking being the same as modulo for negative coords too */
+	FORCEINLINE int32 GetSlotIndex(const FIntPoint& Coords) const
+	{
+		return (Coords.Y & (Dimensions.Y - 1)) * Dimensions.X + (Coords.X & (Dimensions.X - 1));
+	}
+};
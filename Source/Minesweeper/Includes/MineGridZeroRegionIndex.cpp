@@ -0,0 +1,286 @@
+#include "MineGridZeroRegionIndex.h"
+#include "Async/ParallelFor.h"
+
+namespace MineGridZeroRegionIndex
+{
+	// Number of rows scanned by one parallel task
+	static constexpr int32 RowsPerBand = 32;
+}
+
+void FMineGridZeroRegionIndex::Reset()
+{
+	RunStartIndices.Reset();
+	RunEndIndices.Reset();
+	RunRegions.Reset();
+	RegionOffsets.Reset();
+	RegionNumMembers.Reset();
+	RegionCells.Reset();
+}
+
+void FMineGridZeroRegionIndex::Build(const FMineGridMineLayer& MineLayer)
+{
+	using namespace MineGridZeroRegionIndex;
+
+	const int32 Width = MineLayer.GridDimensions.X;
+	const int32 Height = MineLayer.GridDimensions.Y;
+	const int32 RowStride = MineLayer.RowStride;
+
+	Reset();
+
+	auto IsZeroCell = [&MineLayer](const FIntPoint& Coords)
+	{
+		return MineLayer.GetAdjacentMineCount(Coords) == 0 && !MineLayer.IsMine(Coords);
+	};
+
+	//
+	// 1. Runs of member cells, row by row. Bands of rows are scanned in parallel into runs of their own, joined in row order.
+	//
+
+	const int32 NumBands = FMath::DivideAndRoundUp(Height, RowsPerBand);
+
+	// Offset of first run of every row, followed by total number of runs
+	TArray<int32> RowRunOffsets;
+	RowRunOffsets.SetNumUninitialized(Height + 1);
+
+	TArray<TArray<int32>> BandRunStartIndices;
+	TArray<TArray<int32>> BandRunEndIndices;
+	BandRunStartIndices.SetNum(NumBands);
+	BandRunEndIndices.SetNum(NumBands);
+
+	ParallelFor(NumBands, [Width, Height, RowStride, &IsZeroCell, &RowRunOffsets, &BandRunStartIndices, &BandRunEndIndices](const int32 Band)
+	{
+		TArray<int32>& StartIndices = BandRunStartIndices[Band];
+		TArray<int32>& EndIndices = BandRunEndIndices[Band];
+
+		for (int32 Y = Band * RowsPerBand; Y < FMath::Min((Band + 1) * RowsPerBand, Height); Y++)
+		{
+			// Offset within band, rebased once bands are joined
+			RowRunOffsets[Y] = StartIndices.Num();
+
+			for (int32 X = 0; X < Width; X++)
+			{
+				if (!IsZeroCell(FIntPoint(X, Y)))
+				{
+					continue;
+				}
+
+				StartIndices.Add(Y * RowStride + X);
+				while (X + 1 < Width && IsZeroCell(FIntPoint(X + 1, Y)))
+				{
+					X++;
+				}
+				EndIndices.Add(Y * RowStride + X + 1);
+			}
+		}
+	});
+
+	for (int32 Band = 0; Band < NumBands; Band++)
+	{
+		const int32 BandRunOffset = RunStartIndices.Num();
+		for (int32 Y = Band * RowsPerBand; Y < FMath::Min((Band + 1) * RowsPerBand, Height); Y++)
+		{
+			RowRunOffsets[Y] += BandRunOffset;
+		}
+
+		RunStartIndices.Append(BandRunStartIndices[Band]);
+		RunEndIndices.Append(BandRunEndIndices[Band]);
+	}
+	RowRunOffsets[Height] = RunStartIndices.Num();
+
+	const int32 NumRuns = RunStartIndices.Num();
+
+	//
+	// 2. Union-find forest of runs, where root is the lowest run of a region
+	//
+
+	TArray<int32> Parents;
+	Parents.SetNumUninitialized(NumRuns);
+	for (int32 Run = 0; Run < NumRuns; Run++)
+	{
+		Parents[Run] = Run;
+	}
+
+	auto FindRoot = [&Parents](int32 Run)
+	{
+		while (Parents[Run] != Run)
+		{
+			// Path halving
+			Parents[Run] = Parents[Parents[Run]];
+			Run = Parents[Run];
+		}
+		return Run;
+	};
+
+	auto Union = [&Parents, &FindRoot](const int32 Run, const int32 OtherRun)
+	{
+		const int32 Root = FindRoot(Run);
+		const int32 OtherRoot = FindRoot(OtherRun);
+
+		if (Root < OtherRoot)
+		{
+			Parents[OtherRoot] = Root;
+		}
+		else if (OtherRoot < Root)
+		{
+			Parents[Root] = OtherRoot;
+		}
+	};
+
+	// Join runs touching runs of previous row, diagonally included
+	for (int32 Y = 1; Y < Height; Y++)
+	{
+		const int32 RowBase = Y * RowStride;
+		const int32 PrevRowBase = RowBase - RowStride;
+		const int32 PrevRowEndRun = RowRunOffsets[Y];
+
+		int32 PrevRun = RowRunOffsets[Y - 1];
+
+		for (int32 Run = RowRunOffsets[Y]; Run < RowRunOffsets[Y + 1]; Run++)
+		{
+			const int32 StartX = RunStartIndices[Run] - RowBase;
+			const int32 EndX = RunEndIndices[Run] - RowBase;
+
+			// Skip runs ending before cell preceding this run
+			while (PrevRun < PrevRowEndRun && RunEndIndices[PrevRun] - PrevRowBase < StartX)
+			{
+				PrevRun++;
+			}
+			for (int32 OtherRun = PrevRun; OtherRun < PrevRowEndRun && RunStartIndices[OtherRun] - PrevRowBase <= EndX; OtherRun++)
+			{
+				Union(Run, OtherRun);
+			}
+		}
+	}
+
+	//
+	// 3. Compact region labels. Roots come first in run order, so they are labelled before the rest of runs.
+	//
+
+	RunRegions.SetNumUninitialized(NumRuns);
+
+	for (int32 Run = 0; Run < NumRuns; Run++)
+	{
+		const int32 Root = FindRoot(Run);
+		RunRegions[Run] = Root == Run ? RegionNumMembers.Add(0) : RunRegions[Root];
+		RegionNumMembers[RunRegions[Run]] += RunEndIndices[Run] - RunStartIndices[Run];
+	}
+
+	//
+	// 4. Lay out member and border cells of every region. Bands of rows find numbered cells bordering regions in parallel,
+	// every band keeping its own pairs of region and cell, so joining them in row order keeps border cells in cell order.
+	//
+
+	TArray<TArray<TPair<int32, int32>>> BandBorderCells;
+	BandBorderCells.SetNum(NumBands);
+
+	ParallelFor(NumBands, [this, Width, Height, RowStride, &MineLayer, &RowRunOffsets, &BandBorderCells](const int32 Band)
+	{
+		const int32 StartY = Band * RowsPerBand;
+		const int32 EndY = FMath::Min(StartY + RowsPerBand, Height);
+
+		// Regions of cells of three rows around the one being scanned
+		TArray<int32> RowRegions;
+		RowRegions.SetNumUninitialized(3 * Width);
+
+		auto FillRowRegions = [this, Width, RowStride, &RowRunOffsets, &RowRegions](const int32 Y)
+		{
+			int32* Row = RowRegions.GetData() + (Y % 3) * Width;
+			for (int32 X = 0; X < Width; X++)
+			{
+				Row[X] = INDEX_NONE;
+			}
+			for (int32 Run = RowRunOffsets[Y]; Run < RowRunOffsets[Y + 1]; Run++)
+			{
+				for (int32 CellIndex = RunStartIndices[Run]; CellIndex < RunEndIndices[Run]; CellIndex++)
+				{
+					Row[CellIndex - Y * RowStride] = RunRegions[Run];
+				}
+			}
+		};
+
+		if (StartY > 0)
+		{
+			FillRowRegions(StartY - 1);
+		}
+		FillRowRegions(StartY);
+
+		TArray<TPair<int32, int32>>& BorderCells = BandBorderCells[Band];
+
+		for (int32 Y = StartY; Y < EndY; Y++)
+		{
+			if (Y + 1 < Height)
+			{
+				FillRowRegions(Y + 1);
+			}
+
+			for (int32 X = 0; X < Width; X++)
+			{
+				if (RowRegions[(Y % 3) * Width + X] != INDEX_NONE || MineLayer.IsMine(FIntPoint(X, Y)))
+				{
+					continue;
+				}
+
+				// Every distinct region bordered by numbered cell
+				const int32 NumCellBorderedRegions = BorderCells.Num();
+
+				for (int32 NeighbourY = FMath::Max(Y - 1, 0); NeighbourY <= FMath::Min(Y + 1, Height - 1); NeighbourY++)
+				{
+					for (int32 NeighbourX = FMath::Max(X - 1, 0); NeighbourX <= FMath::Min(X + 1, Width - 1); NeighbourX++)
+					{
+						const int32 Region = RowRegions[(NeighbourY % 3) * Width + NeighbourX];
+
+						bool bIsDistinct = Region != INDEX_NONE;
+						for (int32 Index = NumCellBorderedRegions; bIsDistinct && Index < BorderCells.Num(); Index++)
+						{
+							bIsDistinct = BorderCells[Index].Key != Region;
+						}
+
+						if (bIsDistinct)
+						{
+							BorderCells.Emplace(Region, Y * RowStride + X);
+						}
+					}
+				}
+			}
+		}
+	});
+
+	TArray<int32> RegionNumBorders;
+	RegionNumBorders.SetNumZeroed(NumRegions());
+
+	for (const TArray<TPair<int32, int32>>& BorderCells : BandBorderCells)
+	{
+		for (const TPair<int32, int32>& BorderCell : BorderCells)
+		{
+			RegionNumBorders[BorderCell.Key]++;
+		}
+	}
+
+	RegionOffsets.SetNumUninitialized(NumRegions() + 1);
+	RegionOffsets[0] = 0;
+	for (int32 Region = 0; Region < NumRegions(); Region++)
+	{
+		RegionOffsets[Region + 1] = RegionOffsets[Region] + RegionNumMembers[Region] + RegionNumBorders[Region];
+	}
+
+	RegionCells.SetNumUninitialized(RegionOffsets.Last());
+
+	// Write cursor of every region, members being written first
+	TArray<int32> RegionCursors(RegionOffsets.GetData(), NumRegions());
+
+	for (int32 Run = 0; Run < NumRuns; Run++)
+	{
+		for (int32 CellIndex = RunStartIndices[Run]; CellIndex < RunEndIndices[Run]; CellIndex++)
+		{
+			RegionCells[RegionCursors[RunRegions[Run]]++] = CellIndex;
+		}
+	}
+
+	for (const TArray<TPair<int32, int32>>& BorderCells : BandBorderCells)
+	{
+		for (const TPair<int32, int32>& BorderCell : BorderCells)
+		{
+			RegionCells[RegionCursors[BorderCell.Key]++] = BorderCell.Value;
+		}
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Algo/BinarySearch.h"
+#include "MineGridMineLayer.h"
+
+#include "MineGridZeroRegionIndex.generated.h"
+
+/**
+ * Connected regions of mine-free cells having no mines around them, labelled once per mines layout.
+ * Every region lists its member cells followed by numbered cells bordering it, which together are exactly
+ * the cells opened by stepping onto any member. Cells are indexed the same way as dense grid map.
+ * Members are looked up by runs they form in rows, so index grows with regions rather than with map.
+ */
+USTRUCT()
+struct MINESWEEPER_API FMineGridZeroRegionIndex
+{
+	GENERATED_BODY()
+
+	/** Index of first cell of every run of member cells in a row, ascending */
+	UPROPERTY()
+	TArray<int32> RunStartIndices;
+
+	/** Index following last cell of every run */
+	UPROPERTY()
+	TArray<int32> RunEndIndices;
+
+	/** Region of every run */
+	UPROPERTY()
+	TArray<int32> RunRegions;
+
+	/** Offset of first cell of every region in RegionCells, followed by total number of region cells */
+	UPROPERTY()
+	TArray<int32> RegionOffsets;
+
+	/** Number of member cells of every region, the rest of region cells being its border */
+	UPROPERTY()
+	TArray<int32> RegionNumMembers;
+
+	/** Member and border cells of all regions */
+	UPROPERTY()
+	TArray<int32> RegionCells;
+
+	/** Labels regions of given mines layout using union-find over runs of cells with no mines around, scanning bands of rows in parallel */
+	void Build(const FMineGridMineLayer& MineLayer);
+
+	void Reset();
+
+	FORCEINLINE bool IsBuilt() const { return RegionOffsets.Num() > 0; }
+
+	FORCEINLINE int32 NumRegions() const { return RegionNumMembers.Num(); }
+
+	/** Region of cell, INDEX_NONE for cells not being member of any */
+	FORCEINLINE int32 GetRegionAt(const int32 CellIndex) const
+	{
+		const int32 Run = Algo::UpperBound(RunStartIndices, CellIndex) - 1;
+		return Run >= 0 && CellIndex < RunEndIndices[Run] ? RunRegions[Run] : INDEX_NONE;
+	}
+
+	/** Member cells followed by border cells of region */
+	FORCEINLINE TArrayView<const int32> GetRegionCells(const int32 Region) const
+	{
+		return MakeArrayView(RegionCells.GetData() + RegionOffsets[Region], RegionOffsets[Region + 1] - RegionOffsets[Region]);
+	}
+};
@@ -2,7 +2,19 @@
 
 
 #include "MineGridBase.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/Controller.h"
+#include "HAL/PlatformTime.h"
 #include "MineGridCellBase.h"
+#include "Minesweeper/Includes/MineGridTraversal.h"
+
+namespace MineGridBase
+{
+	// Pending cells farther from focus than that share the farthest bucket
+	static constexpr int32 MaxPendingCellBucket = 64;
+}
 
 // Sets default values
 AMineGridBase::AMineGridBase()
@@ -20,85 +32,217 @@ AMineGridBase::AMineGridBase()
 	SetRootComponent(SceneRoot);
 	AddInstanceComponent(SceneRoot);
 
+	// Setup cell instances component, its mesh and material being set in blueprint
+	CellInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("CellInstances"));
+	CellInstances->SetupAttachment(SceneRoot);
+	CellInstances->SetMobility(EComponentMobility::Movable);
+	CellInstances->NumCustomDataFloats = 1;
+
 	// Setting actor defaults
 	GridCellClass = AMineGridCellBase::StaticClass();
 	CellSize = 200.f;
+	bUseGridTriggering = false;
+	bUseInstancedCells = false;
+	bCellPresentationScheduled = false;
+	bCellChangesScheduled = false;
+	NumCellActors = 0;
+	NumPendingCellValues = 0;
+	NearestPendingCellBucket = 0;
+
+	// Applying cell changes takes at most tenth of frame at 60 fps, except for ones around pawn
+	CellChangesFrameBudgetMs = 1.5f;
+	CellChangesImmediateRadius = 1;
+
+	// Enough for cells of default largest map area, which is 17x11 cells extended by 4 prefetched cells ahead
+	// and kept within eviction margin of 2 cells, so 25x19 cells
+	CellPoolPrewarmSize = 25 * 19;
 }
 
 void AMineGridBase::HandleCharacterCellTriggering(AMineGridCellBase* EnteredCell, ACharacter* EnteringCharacter)
 {
-	// Determine coords of cell actor in grid
-	const FIntPoint* FoundEnteredCoordsPtr = GridCoordsCells.FindKey(EnteredCell);
-	if (FoundEnteredCoordsPtr)
+	// Coords of cell actor are known since spawn, only check it is still cell of this grid at them
+	const FMineGridCellSlot* EnteredSlot = EnteredCell ? GridCells.Find(EnteredCell->GridCoords) : nullptr;
+	if (EnteredSlot && EnteredSlot->Cell == EnteredCell && !EnteredSlot->bHasPendingRemoval)
 	{
-		const FIntPoint EnteredCoords = *FoundEnteredCoordsPtr;
+		// Cell value may be newer than one cell actor shows yet
+		if (EnteredSlot->bHasPendingValue && EnteredSlot->PendingValue != EMineGridMapCell::MGMC_Undiscovered)
+		{
+			return;
+		}
+
+		const FIntPoint EnteredCoords = EnteredCell->GridCoords;
 
 		// Broadcast it
 		OnCharacterTriggeredCoords.Broadcast(EnteredCoords);
 	}
 }
 
+void AMineGridBase::BeginTrackingCharacter(ACharacter* Character)
+{
+	if (!UsesGridTriggering() || !Character || TrackedCharacterHandles.Contains(Character))
+	{
+		return;
+	}
+
+	if (USceneComponent* CharacterRootComponent = Character->GetRootComponent())
+	{
+		TrackedCharacterLocations.Emplace(Character, GetGridLocation(Character->GetActorLocation()));
+		TrackedCharacterHandles.Emplace(Character, CharacterRootComponent->TransformUpdated.AddUObject(this, &AMineGridBase::HandleOnTrackedCharacterMoved));
+	}
+}
+
+void AMineGridBase::EndTrackingCharacter(ACharacter* Character)
+{
+	FDelegateHandle TransformUpdatedHandle;
+	if (!TrackedCharacterHandles.RemoveAndCopyValue(Character, TransformUpdatedHandle))
+	{
+		return;
+	}
+
+	TrackedCharacterLocations.Remove(Character);
+
+	if (USceneComponent* CharacterRootComponent = Character->GetRootComponent())
+	{
+		CharacterRootComponent->TransformUpdated.Remove(TransformUpdatedHandle);
+	}
+}
+
+void AMineGridBase::HandleOnTrackedCharacterMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	ACharacter* MovedCharacter = Cast<ACharacter>(UpdatedComponent->GetOwner());
+	FVector2D* PrevLocationPtr = TrackedCharacterLocations.Find(MovedCharacter);
+	if (!PrevLocationPtr)
+	{
+		return;
+	}
+
+	const FVector2D PrevLocation = *PrevLocationPtr;
+	const FVector2D NewLocation = GetGridLocation(MovedCharacter->GetActorLocation());
+	*PrevLocationPtr = NewLocation;
+
+	if (Teleport != ETeleportType::None)
+	{
+		// Teleported character passes through no cells, only landing in one
+		if (MineGridTraversal::GetCellCoords(NewLocation) != MineGridTraversal::GetCellCoords(PrevLocation))
+		{
+			TriggerCellAt(MineGridTraversal::GetCellCoords(NewLocation), MovedCharacter);
+		}
+		return;
+	}
+
+	// Trigger every entered cell once, however far character moved since previous update
+	MineGridTraversal::ForEachCellOnSegment(PrevLocation, NewLocation, [this, MovedCharacter](const FIntPoint& EnteredCoords)
+	{
+		TriggerCellAt(EnteredCoords, MovedCharacter);
+	});
+}
+
+void AMineGridBase::TriggerCellAt(const FIntPoint& CellCoords, ACharacter* EnteringCharacter)
+{
+	const FMineGridCellSlot* EnteredSlot = GridCells.Find(CellCoords);
+	if (!EnteredSlot)
+	{
+		return;
+	}
+
+	// Pending changes are newer than shown cells, so they decide whether cell can be triggered
+	if (EnteredSlot->bHasPendingRemoval)
+	{
+		return;
+	}
+
+	if (EnteredSlot->bHasPendingValue)
+	{
+		if (EnteredSlot->PendingValue == EMineGridMapCell::MGMC_Undiscovered)
+		{
+			OnCharacterTriggeredCoords.Broadcast(CellCoords);
+		}
+		return;
+	}
+
+	if (bUseInstancedCells)
+	{
+		// Only undiscovered cells are triggered, as cell actors do
+		if (EnteredSlot->InstanceIndex != INDEX_NONE && CellInstanceValues[EnteredSlot->InstanceIndex] == EMineGridMapCell::MGMC_Undiscovered)
+		{
+			OnCharacterTriggeredCoords.Broadcast(CellCoords);
+		}
+		return;
+	}
+
+	AMineGridCellBase* EnteredCell = EnteredSlot->Cell;
+	if (EnteredCell && EnteredCell->CanBeTriggered())
+	{
+		HandleCharacterCellTriggering(EnteredCell, EnteringCharacter);
+	}
+}
+
+FVector2D AMineGridBase::GetGridLocation(const FVector& WorldLocation) const
+{
+	// The same mapping as of player controller's map area, which takes integral part of relative location
+	const FVector RelativeLocation = (WorldLocation - GetActorLocation()) / CellSize;
+	return FVector2D(RelativeLocation.X, RelativeLocation.Y);
+}
+
 void AMineGridBase::AddOrRemoveGridCells(const FMineGridMapChanges& GridMapChanges)
 {
-	GridCoordsCells.Reserve(GridMapChanges.NewGridDimensions.X * GridMapChanges.NewGridDimensions.Y);
+	// Window of cell slots holds twice the map area, so cells entering moving area never alias cells it left,
+	// which stay shown until their queued removals are applied
+	GridCells.Reserve(GridMapChanges.NewGridDimensions * 2);
+
+	TArray<FIntPoint> FocusCoords;
+	GetCellChangesFocusCoords(FocusCoords);
+	UpdatePendingCellBuckets(FocusCoords);
 
-	// Remove and destroy cell actors
+	// Remove cells
 	for (const FIntPoint& RemovedCoords : GridMapChanges.RemovedGridMapCells)
 	{
-		if (auto CellRefCountsPtr = GridCellRefCounts.Find(RemovedCoords))
+		if (FMineGridCellSlot* RemovedSlot = GridCells.Find(RemovedCoords))
 		{
-			if (*CellRefCountsPtr > 0)
+			if (RemovedSlot->RefCount > 0)
 			{
-				GridCellRefCounts[RemovedCoords]--;
+				RemovedSlot->RefCount--;
 			}
 			else
 			{
-				UE_LOG(LogTemp, Warning, TEXT("Decrementable GridCellRefCounts[%s] is already zero."), *RemovedCoords.ToString());
+				UE_LOG(LogTemp, Warning, TEXT("Decrementable RefCount of cell %s is already zero."), *RemovedCoords.ToString());
 			}
 
-			// Remove and destroy actor only if has no more references
-			if (*CellRefCountsPtr == 0)
+			// Remove cell only if has no more references
+			if (RemovedSlot->RefCount == 0)
 			{
-				GridCellRefCounts.Remove(RemovedCoords);
-
-				if (AMineGridCellBase* CellActor = GridCoordsCells.FindAndRemoveChecked(RemovedCoords))
-				{
-					CellActor->Destroy();
-				}
+				QueueCellRemoval(RemovedCoords, IsNearCellChangesFocus(RemovedCoords, FocusCoords));
+				ReleaseCellSlot(RemovedCoords);
 			}
 		}
 	}
 
-	// Spawn and add cell actors
+	// Add cells
 	auto AddedCoordsIt = GridMapChanges.AddedGridMapCellCoords.CreateConstIterator();
 	auto AddedValuesIt = GridMapChanges.AddedGridMapCellValues.CreateConstIterator();
 
 	for (AddedCoordsIt, AddedValuesIt; AddedCoordsIt && AddedValuesIt; ++AddedCoordsIt, ++AddedValuesIt)
 	{
-		if (!GridCellRefCounts.Contains(*AddedCoordsIt))
+		// Add cell only if previously has no references
+		const bool bAddedCell = GridCells.FindOrAdd(*AddedCoordsIt).RefCount++ == 0;
+		if (bAddedCell)
 		{
-			GridCellRefCounts.Emplace(*AddedCoordsIt, 0);
+			QueueCellValue(*AddedCoordsIt, *AddedValuesIt, IsNearCellChangesFocus(*AddedCoordsIt, FocusCoords));
 		}
-
-		// Spawn cell only if previously has no references
-		if (GridCellRefCounts[*AddedCoordsIt] == 0)
-		{
-			if (AMineGridCellBase* NewCellActor = SpawnCellAt(*AddedCoordsIt))
-			{
-				NewCellActor->UpdateCellValue(*AddedValuesIt);
-				GridCoordsCells.Emplace(*AddedCoordsIt, NewCellActor);
-			}
-		}
-
-		GridCellRefCounts[*AddedCoordsIt]++;
 	}
 
 	// Update grid-dimensions
 	GridDimensions = GridMapChanges.NewGridDimensions;
+
+	ScheduleCellChanges();
 }
 
 void AMineGridBase::UpdateCellValues(const FMineGridMapCellUpdates& UpdatedMineGridMapCells)
 {
+	TArray<FIntPoint> FocusCoords;
+	GetCellChangesFocusCoords(FocusCoords);
+	UpdatePendingCellBuckets(FocusCoords);
+
 	auto UpdatedCellCoordsIt = UpdatedMineGridMapCells.UpdatedGridMapCellCoords.CreateConstIterator();
 	auto UpdatedCellValuesIt = UpdatedMineGridMapCells.UpdatedGridMapCellValues.CreateConstIterator();
 
@@ -107,27 +251,405 @@ void AMineGridBase::UpdateCellValues(const FMineGridMapCellUpdates& UpdatedMineG
 		const FIntPoint Coords = *UpdatedCellCoordsIt;
 		const EMineGridMapCell NewCellValue = *UpdatedCellValuesIt;
 
-		if (AMineGridCellBase* CellActor = GridCoordsCells[Coords])
+		const FMineGridCellSlot* UpdatedSlot = GridCells.Find(Coords);
+		if (UpdatedSlot && UpdatedSlot->RefCount > 0)
+		{
+			QueueCellValue(Coords, NewCellValue, IsNearCellChangesFocus(Coords, FocusCoords));
+		}
+	}
+
+	ScheduleCellChanges();
+}
+
+void AMineGridBase::FlushCellChanges()
+{
+	for (const FIntPoint& RemovedCoords : PendingRemovedCells)
+	{
+		ApplyPendingCellRemoval(RemovedCoords);
+	}
+	PendingRemovedCells.Reset();
+
+	// Every pending cell is in one of buckets
+	for (TArray<FIntPoint>& PendingCellBucket : PendingCellBuckets)
+	{
+		for (const FIntPoint& CellCoords : PendingCellBucket)
+		{
+			ApplyPendingCellValue(CellCoords);
+		}
+		PendingCellBucket.Reset();
+	}
+	NearestPendingCellBucket = 0;
+}
+
+void AMineGridBase::QueueCellValue(const FIntPoint& CellCoords, const EMineGridMapCell CellValue, const bool bApplyImmediately)
+{
+	FMineGridCellSlot& CellSlot = GridCells.FindOrAdd(CellCoords);
+	CellSlot.bHasPendingRemoval = false;
+
+	if (bApplyImmediately || CellChangesFrameBudgetMs <= 0.f)
+	{
+		DropPendingCellValue(CellSlot);
+		ApplyCellValue(CellCoords, CellValue);
+	}
+	else
+	{
+		CellSlot.PendingValue = CellValue;
+
+		// Cell already pending keeps its bucket
+		if (!CellSlot.bHasPendingValue)
+		{
+			CellSlot.bHasPendingValue = true;
+			NumPendingCellValues++;
+			AddPendingCellToBucket(CellCoords);
+		}
+	}
+}
+
+void AMineGridBase::QueueCellRemoval(const FIntPoint& CellCoords, const bool bApplyImmediately)
+{
+	FMineGridCellSlot* RemovedSlot = GridCells.Find(CellCoords);
+	if (!RemovedSlot)
+	{
+		return;
+	}
+
+	DropPendingCellValue(*RemovedSlot);
+
+	if (bApplyImmediately || CellChangesFrameBudgetMs <= 0.f)
+	{
+		RemovedSlot->bHasPendingRemoval = false;
+		ApplyCellRemoval(CellCoords);
+	}
+	else if ((RemovedSlot->Cell || RemovedSlot->InstanceIndex != INDEX_NONE) && !RemovedSlot->bHasPendingRemoval)
+	{
+		// Only shown cell is to be hidden
+		RemovedSlot->bHasPendingRemoval = true;
+		PendingRemovedCells.Add(CellCoords);
+	}
+}
+
+bool AMineGridBase::ApplyPendingCellValue(const FIntPoint& CellCoords)
+{
+	FMineGridCellSlot* CellSlot = GridCells.Find(CellCoords);
+	if (!CellSlot || !CellSlot->bHasPendingValue)
+	{
+		return false;
+	}
+
+	const EMineGridMapCell CellValue = CellSlot->PendingValue;
+	DropPendingCellValue(*CellSlot);
+	ApplyCellValue(CellCoords, CellValue);
+	return true;
+}
+
+bool AMineGridBase::ApplyPendingCellRemoval(const FIntPoint& CellCoords)
+{
+	FMineGridCellSlot* CellSlot = GridCells.Find(CellCoords);
+	if (!CellSlot || !CellSlot->bHasPendingRemoval)
+	{
+		return false;
+	}
+
+	CellSlot->bHasPendingRemoval = false;
+	ApplyCellRemoval(CellCoords);
+	return true;
+}
+
+void AMineGridBase::DropPendingCellValue(FMineGridCellSlot& CellSlot)
+{
+	if (CellSlot.bHasPendingValue)
+	{
+		CellSlot.bHasPendingValue = false;
+		NumPendingCellValues--;
+	}
+}
+
+void AMineGridBase::ApplyCellValue(const FIntPoint& CellCoords, const EMineGridMapCell CellValue)
+{
+	FMineGridCellSlot& CellSlot = GridCells.FindOrAdd(CellCoords);
+
+	if (bUseInstancedCells)
+	{
+		if (CellSlot.InstanceIndex != INDEX_NONE)
+		{
+			UpdateCellInstanceValue(CellSlot.InstanceIndex, CellValue);
+		}
+		else
+		{
+			CellSlot.InstanceIndex = AddCellInstanceAt(CellCoords, CellValue);
+		}
+
+		ScheduleCellPresentation();
+	}
+	else if (AMineGridCellBase* CellActor = CellSlot.Cell)
+	{
+		// Cell can be triggered according to new value right away, while its text and material follow next tick
+		if (CellActor->SetCellValue(CellValue))
+		{
+			CellsPendingPresentation.Add(CellActor);
+			ScheduleCellPresentation();
+		}
+	}
+	else if (AMineGridCellBase* NewCellActor = AcquireCellAt(CellCoords))
+	{
+		NewCellActor->UpdateCellValue(CellValue);
+		CellSlot.Cell = NewCellActor;
+
+		NumCellActors++;
+		CellPoolStats.HighWaterMark = FMath::Max(CellPoolStats.HighWaterMark, NumCellActors);
+	}
+}
+
+void AMineGridBase::ApplyCellRemoval(const FIntPoint& CellCoords)
+{
+	FMineGridCellSlot* CellSlot = GridCells.Find(CellCoords);
+	if (!CellSlot)
+	{
+		return;
+	}
+
+	if (CellSlot->InstanceIndex != INDEX_NONE)
+	{
+		RemoveCellInstance(CellSlot->InstanceIndex);
+		CellSlot->InstanceIndex = INDEX_NONE;
+		ScheduleCellPresentation();
+	}
+
+	if (AMineGridCellBase* CellActor = CellSlot->Cell)
+	{
+		CellSlot->Cell = nullptr;
+		NumCellActors--;
+		ReleaseCell(CellActor);
+	}
+
+	ReleaseCellSlot(CellCoords);
+}
+
+void AMineGridBase::ReleaseCellSlot(const FIntPoint& CellCoords)
+{
+	const FMineGridCellSlot* CellSlot = GridCells.Find(CellCoords);
+	if (CellSlot && !CellSlot->IsUsed())
+	{
+		GridCells.Remove(CellCoords);
+	}
+}
+
+void AMineGridBase::ScheduleCellChanges()
+{
+	if (!bCellChangesScheduled && (PendingRemovedCells.Num() > 0 || NumPendingCellValues > 0))
+	{
+		bCellChangesScheduled = true;
+		GetWorldTimerManager().SetTimerForNextTick(this, &AMineGridBase::ApplyPendingCellChanges);
+	}
+}
+
+void AMineGridBase::ApplyPendingCellChanges()
+{
+	bCellChangesScheduled = false;
+
+	// At least one change is applied every tick, so queue drains however small budget is
+	const double DeadlineSeconds = FPlatformTime::Seconds() + CellChangesFrameBudgetMs * 0.001;
+	bool bOverBudget = false;
+
+	// Removals go first, as they return cell actors to pool for added cells to take
+	while (PendingRemovedCells.Num() > 0 && !bOverBudget)
+	{
+		if (ApplyPendingCellRemoval(PendingRemovedCells.Pop(false)))
+		{
+			bOverBudget = FPlatformTime::Seconds() >= DeadlineSeconds;
+		}
+	}
+
+	if (!bOverBudget && NumPendingCellValues > 0)
+	{
+		TArray<FIntPoint> FocusCoords;
+		GetCellChangesFocusCoords(FocusCoords);
+		UpdatePendingCellBuckets(FocusCoords);
+
+		// Every pending cell is in bucket not nearer than nearest one, so there is always one to be found
+		while (NumPendingCellValues > 0 && !bOverBudget)
+		{
+			while (PendingCellBuckets[NearestPendingCellBucket].Num() == 0)
+			{
+				NearestPendingCellBucket++;
+			}
+
+			if (ApplyPendingCellValue(PendingCellBuckets[NearestPendingCellBucket].Pop(false)))
+			{
+				bOverBudget = FPlatformTime::Seconds() >= DeadlineSeconds;
+			}
+		}
+
+		// Drop coords of cells left in buckets after they stopped being pending
+		if (NumPendingCellValues == 0)
+		{
+			for (TArray<FIntPoint>& PendingCellBucket : PendingCellBuckets)
+			{
+				PendingCellBucket.Reset();
+			}
+			NearestPendingCellBucket = 0;
+		}
+	}
+
+	ScheduleCellChanges();
+}
+
+void AMineGridBase::GetCellChangesFocusCoords(TArray<FIntPoint>& OutFocusCoords) const
+{
+	OutFocusCoords.Reset();
+
+	// Possessed pawns, cells around which are looked at by local players and walked on by every player. Clients hold
+	// controllers of their local players only, while server holds every one, its cells triggering ones remote pawns overlap.
+	if (UWorld* World = GetWorld())
+	{
+		for (FConstControllerIterator ControllerIt = World->GetControllerIterator(); ControllerIt; ++ControllerIt)
+		{
+			const AController* Controller = ControllerIt->Get();
+			const APawn* PossessedPawn = Controller ? Controller->GetPawn() : nullptr;
+			if (PossessedPawn)
+			{
+				OutFocusCoords.AddUnique(MineGridTraversal::GetCellCoords(GetGridLocation(PossessedPawn->GetActorLocation())));
+			}
+		}
+	}
+
+	// Characters triggering cells by grid, for which pending cells decide what can be triggered
+	for (const TPair<ACharacter*, FVector2D>& TrackedCharacterLocation : TrackedCharacterLocations)
+	{
+		OutFocusCoords.AddUnique(MineGridTraversal::GetCellCoords(TrackedCharacterLocation.Value));
+	}
+}
+
+int32 AMineGridBase::GetCellChangesFocusDistance(const FIntPoint& CellCoords, const TArray<FIntPoint>& FocusCoords)
+{
+	int32 FocusDistance = FocusCoords.Num() > 0 ? MAX_int32 : 0;
+	for (const FIntPoint& Focus : FocusCoords)
+	{
+		const FIntPoint Offset = CellCoords - Focus;
+		FocusDistance = FMath::Min(FocusDistance, FMath::Max(FMath::Abs(Offset.X), FMath::Abs(Offset.Y)));
+	}
+	return FocusDistance;
+}
+
+bool AMineGridBase::IsNearCellChangesFocus(const FIntPoint& CellCoords, const TArray<FIntPoint>& FocusCoords) const
+{
+	return FocusCoords.Num() > 0 && GetCellChangesFocusDistance(CellCoords, FocusCoords) <= CellChangesImmediateRadius;
+}
+
+void AMineGridBase::UpdatePendingCellBuckets(const TArray<FIntPoint>& FocusCoords)
+{
+	if (FocusCoords == PendingCellBucketsFocus)
+	{
+		return;
+	}
+
+	PendingCellBucketsFocus = FocusCoords;
+
+	for (TArray<FIntPoint>& PendingCellBucket : PendingCellBuckets)
+	{
+		PendingCellBucket.Reset();
+	}
+	NearestPendingCellBucket = 0;
+
+	if (NumPendingCellValues > 0)
+	{
+		GridCells.ForEach([this](const FIntPoint& CellCoords, const FMineGridCellSlot& CellSlot)
+		{
+			if (CellSlot.bHasPendingValue)
+			{
+				AddPendingCellToBucket(CellCoords);
+			}
+		});
+	}
+}
+
+void AMineGridBase::AddPendingCellToBucket(const FIntPoint& CellCoords)
+{
+	const int32 Bucket = FMath::Min(GetCellChangesFocusDistance(CellCoords, PendingCellBucketsFocus), MineGridBase::MaxPendingCellBucket);
+	if (PendingCellBuckets.Num() <= Bucket)
+	{
+		PendingCellBuckets.SetNum(Bucket + 1);
+	}
+
+	PendingCellBuckets[Bucket].Add(CellCoords);
+	NearestPendingCellBucket = FMath::Min(NearestPendingCellBucket, Bucket);
+}
+
+void AMineGridBase::ScheduleCellPresentation()
+{
+	if (!bCellPresentationScheduled)
+	{
+		bCellPresentationScheduled = true;
+		GetWorldTimerManager().SetTimerForNextTick(this, &AMineGridBase::PresentPendingCellValues);
+	}
+}
+
+void AMineGridBase::PresentPendingCellValues()
+{
+	bCellPresentationScheduled = false;
+
+	for (AMineGridCellBase* CellActor : CellsPendingPresentation)
+	{
+		if (IsValid(CellActor))
 		{
-			CellActor->UpdateCellValue(NewCellValue);
+			CellActor->UpdateCellPresentation();
 		}
 	}
+	CellsPendingPresentation.Reset();
+
+	// Instances were edited without marking render state dirty, so mark it once for all of them
+	if (bUseInstancedCells)
+	{
+		CellInstances->MarkRenderStateDirty();
+	}
 }
 
 // Called when the game starts or when spawned
 void AMineGridBase::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// Pre-warm pool, so walking around grid spawns no cell actors
+	ReserveCellPool(CellPoolPrewarmSize);
 }
 
-AMineGridCellBase* AMineGridBase::SpawnCellAt(const FIntPoint& CellCoords)
+void AMineGridBase::ReserveCellPool(const int32 NumCells)
 {
-	const int XOffset = CellCoords.X;
-	const int YOffset = CellCoords.Y;
+	// Instanced cells need no actors
+	if (bUseInstancedCells)
+	{
+		return;
+	}
 
+	PooledCells.Reserve(NumCells - NumCellActors);
+	while (NumCellActors + PooledCells.Num() < NumCells)
+	{
+		AMineGridCellBase* PooledCell = SpawnCellAt(FIntPoint::ZeroValue);
+		if (!PooledCell)
+		{
+			break;
+		}
+
+		PooledCell->DeactivateCell();
+		PooledCells.Add(PooledCell);
+	}
+}
+
+void AMineGridBase::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	AMineGridBase* This = CastChecked<AMineGridBase>(InThis);
+	This->GridCells.ForEach([This, &Collector](const FIntPoint& CellCoords, FMineGridCellSlot& CellSlot)
+	{
+		Collector.AddReferencedObject(CellSlot.Cell, This);
+	});
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+AMineGridCellBase* AMineGridBase::SpawnCellAt(const FIntPoint& CellCoords)
+{
 	// Make position vector, offset from Grid location
-	const FVector BlockLocation = FVector(XOffset, YOffset, 0.f) * CellSize + GetActorLocation();
+	const FVector BlockLocation = GetCellLocation(CellCoords);
 
 	// Spawn a cell
 	AMineGridCellBase* NewCell = GetWorld()->SpawnActor<AMineGridCellBase>(GridCellClass, BlockLocation, FRotator(0, 0, 0));
@@ -136,9 +658,88 @@ AMineGridCellBase* AMineGridBase::SpawnCellAt(const FIntPoint& CellCoords)
 	{
 		// Setup owner of new cell
 		NewCell->OwnerGrid = this;
+		NewCell->GridCoords = CellCoords;
+
+		// Cells triggered by grid need no physics bodies
+		if (UsesGridTriggering())
+		{
+			NewCell->DisableTriggerBox();
+		}
 
 		return NewCell;
 	}
 
 	return nullptr;
 }
+
+int32 AMineGridBase::AddCellInstanceAt(const FIntPoint& CellCoords, const EMineGridMapCell CellValue)
+{
+	// Instance is placed relative to grid as cell actor would be
+	const FTransform InstanceTransform(FVector(CellCoords.X, CellCoords.Y, 0.f) * CellSize);
+
+	int32 InstanceIndex;
+	if (FreeCellInstances.Num() > 0)
+	{
+		InstanceIndex = FreeCellInstances.Pop(false);
+		CellInstances->UpdateInstanceTransform(InstanceIndex, InstanceTransform, false, false, true);
+	}
+	else
+	{
+		InstanceIndex = CellInstances->AddInstance(InstanceTransform);
+		CellInstanceValues.SetNum(FMath::Max(CellInstanceValues.Num(), InstanceIndex + 1));
+	}
+
+	UpdateCellInstanceValue(InstanceIndex, CellValue);
+
+	return InstanceIndex;
+}
+
+void AMineGridBase::RemoveCellInstance(const int32 InstanceIndex)
+{
+	// Zero scale hides instance without removing it, which would move other instances to its index
+	CellInstances->UpdateInstanceTransform(InstanceIndex, FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector), false, false, true);
+	FreeCellInstances.Add(InstanceIndex);
+}
+
+void AMineGridBase::UpdateCellInstanceValue(const int32 InstanceIndex, const EMineGridMapCell CellValue)
+{
+	// Custom data of instance always matches its value, including zero of new instances
+	if (CellInstanceValues[InstanceIndex] == CellValue)
+	{
+		return;
+	}
+
+	CellInstanceValues[InstanceIndex] = CellValue;
+	CellInstances->SetCustomDataValue(InstanceIndex, 0, (float)CellValue, false);
+}
+
+AMineGridCellBase* AMineGridBase::AcquireCellAt(const FIntPoint& CellCoords)
+{
+	while (PooledCells.Num() > 0)
+	{
+		// Pooled cell may be gone with its level
+		AMineGridCellBase* PooledCell = PooledCells.Pop(false);
+		if (IsValid(PooledCell))
+		{
+			CellPoolStats.NumHits++;
+
+			PooledCell->ActivateCell(this, CellCoords, GetCellLocation(CellCoords));
+			return PooledCell;
+		}
+	}
+
+	CellPoolStats.NumMisses++;
+
+	return SpawnCellAt(CellCoords);
+}
+
+void AMineGridBase::ReleaseCell(AMineGridCellBase* CellActor)
+{
+	CellActor->DeactivateCell();
+	PooledCells.Add(CellActor);
+}
+
+FVector AMineGridBase::GetCellLocation(const FIntPoint& CellCoords) const
+{
+	return FVector(CellCoords.X, CellCoords.Y, 0.f) * CellSize + GetActorLocation();
+}
@@ -5,12 +5,61 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Minesweeper/Includes/MineGridMapChanges.h"
+#include "Minesweeper/Includes/MineGridWindow.h"
 #include "MineGridCellBase.h"
 
 #include "MineGridBase.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCharacterTriggeredCoordsDelegate, const FIntPoint&, EnteredIntoCoords);
 
+/**
+ * Usage stats of pool of cell actors
+ */
+USTRUCT(BlueprintType)
+struct FMineGridCellPoolStats
+{
+	GENERATED_BODY()
+
+	// Number of cells taken from pool
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGrid|Pool")
+	int32 NumHits = 0;
+
+	// Number of cells spawned as pool was empty
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGrid|Pool")
+	int32 NumMisses = 0;
+
+	// Max number of cells shown at once
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGrid|Pool")
+	int32 HighWaterMark = 0;
+};
+
+/**
+ * Cell shown by grid, along with what shows it
+ */
+struct FMineGridCellSlot
+{
+	// Number of map areas holding cell
+	uint8 RefCount = 0;
+
+	// Cell actor showing cell, if any
+	class AMineGridCellBase* Cell = nullptr;
+
+	// Instance showing cell in instanced mode, if any
+	int32 InstanceIndex = INDEX_NONE;
+
+	// Value to be shown once queued change of cell is applied
+	EMineGridMapCell PendingValue = EMineGridMapCell::MGMC_Undiscovered;
+
+	// Whether cell has queued value, kept along with cell so checking it needs no lookup of its own
+	bool bHasPendingValue = false;
+
+	// Whether cell has queued removal
+	bool bHasPendingRemoval = false;
+
+	// Whether slot holds anything, cell being still shown for a while after its last reference is gone
+	FORCEINLINE bool IsUsed() const { return RefCount > 0 || Cell != nullptr || InstanceIndex != INDEX_NONE; }
+};
+
 /**
  * This native actor defines actual mine grid placed in world to be played on.
  * Manages mine grid cells actors. Used by MinesweeeperGameModeBase. Currently supporting only 
@@ -40,8 +89,33 @@ public:
 	UFUNCTION()
 	void UpdateCellValues(const FMineGridMapCellUpdates& UpdatedMineGridMapCells);
 
+	// Applies all queued cell changes right away, regardless of frame budget
+	UFUNCTION(BlueprintCallable)
+	void FlushCellChanges();
+
 	FORCEINLINE float GetCellSize() { return CellSize; }
 
+	// Starts triggering cells given character enters, if grid triggers them instead of cell trigger boxes
+	void BeginTrackingCharacter(class ACharacter* Character);
+
+	// Stops triggering cells given character enters
+	void EndTrackingCharacter(class ACharacter* Character);
+
+	// Whether cells are drawn as instances of single mesh component instead of cell actors
+	FORCEINLINE bool UsesInstancedCells() const { return bUseInstancedCells; }
+
+	UFUNCTION(BlueprintCallable)
+	FORCEINLINE FMineGridCellPoolStats GetCellPoolStats() const { return CellPoolStats; }
+
+	// Grows pool until it and shown cells hold given number of cell actors, so that many cells are shown without spawning
+	void ReserveCellPool(const int32 NumCells);
+
+	// Slots of shown cells by their coordinates
+	FORCEINLINE const TMineGridWindow<FMineGridCellSlot>& GetGridCells() const { return GridCells; }
+
+	// Keeps cell actors held by slots of shown cells referenced, as window of slots is no property
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
 protected:
 
 	// Subclass of cell actor class to use for spawning
@@ -52,21 +126,178 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "MineGrid")
 	float CellSize;
 
-	// Mapping between cells and it's coordinates
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGrid")
-	TMap<FIntPoint, AMineGridCellBase*> GridCoordsCells;
+	// Cells by their coordinates, with number of holding references to ensure visibility and what shows them.
+	// Window is sized to map area, so slots of moving area are looked up by array indexing.
+	TMineGridWindow<FMineGridCellSlot> GridCells;
+
+	// Number of cell actors currently showing cells
+	int32 NumCellActors;
 
 	// Horizontal and vertical size of grid
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGrid")
 	FIntPoint GridDimensions;
 
-	// Number of holding references to cells to ensure visibility
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGrid")
-	TMap<FIntPoint, uint8> GridCellRefCounts;
+	// Whether cells are triggered by grid following tracked characters, instead of overlaps with trigger boxes of cells
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "MineGrid")
+	bool bUseGridTriggering;
+
+	/**
+	 * Whether cells are drawn as instances of CellInstances instead of spawning cell actors. Value of each cell is
+	 * passed to instance material as its first custom data float, and cells are triggered by grid.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "MineGrid|Instancing")
+	bool bUseInstancedCells;
+
+	// Draws all cells in instanced mode, being movable as its instances change with every step of map area
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGrid|Instancing")
+	class UInstancedStaticMeshComponent* CellInstances;
+
+	// Values of cells drawn by instances, by instance index
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGrid|Instancing")
+	TArray<EMineGridMapCell> CellInstanceValues;
+
+	// Hidden instances of removed cells, reused for added ones so no instance is ever removed and indices stay stable
+	TArray<int32> FreeCellInstances;
+
+	// Locations of tracked characters relative to grid in cell units, as of their latest move
+	TMap<class ACharacter*, FVector2D> TrackedCharacterLocations;
+
+	// Handles of root component transform bindings of tracked characters
+	TMap<class ACharacter*, FDelegateHandle> TrackedCharacterHandles;
+
+	// Number of cell actors spawned hidden on begin play, so shown cells are taken from pool instead of being spawned.
+	// Local player controllers grow pool further to fit their largest map area.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "MineGrid|Pool", meta = (ClampMin = "0"))
+	int32 CellPoolPrewarmSize;
+
+	// Hidden cell actors ready to be shown again
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGrid|Pool")
+	TArray<AMineGridCellBase*> PooledCells;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGrid|Pool")
+	FMineGridCellPoolStats CellPoolStats;
+
+	// Cell actors whose values changed since last presentation, their text and material being updated once per tick
+	UPROPERTY()
+	TSet<AMineGridCellBase*> CellsPendingPresentation;
+
+	// Whether presentation of changed cell values is scheduled for next tick
+	bool bCellPresentationScheduled;
+
+	/**
+	 * Milliseconds per tick queued cell changes are applied within, nearest to possessed pawns and tracked characters first.
+	 * Non-positive value applies all changes right away.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "MineGrid|Budget")
+	float CellChangesFrameBudgetMs;
+
+	// Number of cells around possessed pawns and tracked characters changes of which are applied right away, never being queued
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "MineGrid|Budget")
+	uint8 CellChangesImmediateRadius;
+
+	// Number of cells with values to be added or updated over next ticks, values being held by slots of cells
+	int32 NumPendingCellValues;
+
+	// Coords of cells with pending values by their distance to nearest focus, so nearest ones are applied first without
+	// ordering all of them every tick. Coords of cells no longer pending are skipped once reached.
+	TArray<TArray<FIntPoint>> PendingCellBuckets;
+
+	// Distance of nearest bucket which may hold pending cells
+	int32 NearestPendingCellBucket;
+
+	// Focus coords buckets of pending cells are sorted by, buckets being rebuilt only once focus changes
+	TArray<FIntPoint> PendingCellBucketsFocus;
+
+	// Cells to be removed over next ticks, ones whose slots no longer have removal pending being skipped
+	TArray<FIntPoint> PendingRemovedCells;
+
+	// Whether applying queued cell changes is scheduled for next tick
+	bool bCellChangesScheduled;
 
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
 	// Performs spawning cell actor
 	AMineGridCellBase* SpawnCellAt(const FIntPoint& CellCoords);
+
+	// Shows pooled cell actor at given coords, spawning new one only if pool is empty
+	AMineGridCellBase* AcquireCellAt(const FIntPoint& CellCoords);
+
+	// Hides cell actor and returns it to pool instead of destroying it
+	void ReleaseCell(AMineGridCellBase* CellActor);
+
+	// Queues cell value to be shown, or shows it right away
+	void QueueCellValue(const FIntPoint& CellCoords, const EMineGridMapCell CellValue, const bool bApplyImmediately);
+
+	// Queues cell to be removed, or removes it right away
+	void QueueCellRemoval(const FIntPoint& CellCoords, const bool bApplyImmediately);
+
+	// Shows cell with given value by cell actor or instance, adding one if not shown yet
+	void ApplyCellValue(const FIntPoint& CellCoords, const EMineGridMapCell CellValue);
+
+	// Returns cell actor to pool or frees its instance
+	void ApplyCellRemoval(const FIntPoint& CellCoords);
+
+	// Shows pending value of cell at given coords, returning whether it had one
+	bool ApplyPendingCellValue(const FIntPoint& CellCoords);
+
+	// Removes cell at given coords if its removal is pending, returning whether it was
+	bool ApplyPendingCellRemoval(const FIntPoint& CellCoords);
+
+	// Drops pending value of cell, if any
+	void DropPendingCellValue(FMineGridCellSlot& CellSlot);
+
+	// Frees slot of cell at given coords once it holds nothing
+	void ReleaseCellSlot(const FIntPoint& CellCoords);
+
+	// Applies queued cell changes on next tick
+	void ScheduleCellChanges();
+
+	// Applies queued cell changes nearest to focus first, until frame budget runs out
+	void ApplyPendingCellChanges();
+
+	// Coords of cells possessed pawns and tracked characters are in, as cells around them are looked at and walked on
+	void GetCellChangesFocusCoords(TArray<FIntPoint>& OutFocusCoords) const;
+
+	// Number of cells between given cell and nearest focus in either direction, zero if there is no focus
+	static int32 GetCellChangesFocusDistance(const FIntPoint& CellCoords, const TArray<FIntPoint>& FocusCoords);
+
+	// Whether changes of cell at given coords are applied right away, being around focus
+	bool IsNearCellChangesFocus(const FIntPoint& CellCoords, const TArray<FIntPoint>& FocusCoords) const;
+
+	// Sorts pending cells into buckets by distance to given focus, unless they are sorted by it already
+	void UpdatePendingCellBuckets(const TArray<FIntPoint>& FocusCoords);
+
+	// Puts pending cell into bucket of its distance to focus of buckets
+	void AddPendingCellToBucket(const FIntPoint& CellCoords);
+
+	// Presents changed cell values on next tick, so that any number of updates during this one dirties render state once
+	void ScheduleCellPresentation();
+
+	// Updates text and material of changed cell actors and custom data of changed instances
+	void PresentPendingCellValues();
+
+	// Location of cell at given coords in world
+	FVector GetCellLocation(const FIntPoint& CellCoords) const;
+
+	// Shows cell at given coords by free or new instance, returning its index
+	int32 AddCellInstanceAt(const FIntPoint& CellCoords, const EMineGridMapCell CellValue);
+
+	// Hides given instance and frees it for reuse
+	void RemoveCellInstance(const int32 InstanceIndex);
+
+	// Passes new cell value to material of its instance
+	void UpdateCellInstanceValue(const int32 InstanceIndex, const EMineGridMapCell CellValue);
+
+	// Whether cells are triggered by grid, as they are in instanced mode having no trigger boxes
+	FORCEINLINE bool UsesGridTriggering() const { return bUseGridTriggering || bUseInstancedCells; }
+
+	// Triggers every cell tracked character passes through while moving
+	void HandleOnTrackedCharacterMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	// Triggers cell at given coords if it is spawned and undiscovered
+	void TriggerCellAt(const FIntPoint& CellCoords, class ACharacter* EnteringCharacter);
+
+	// Location relative to grid in cell units
+	FVector2D GetGridLocation(const FVector& WorldLocation) const;
 };
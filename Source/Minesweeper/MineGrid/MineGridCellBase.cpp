@@ -13,9 +13,15 @@ AMineGridCellBase::AMineGridCellBase()
 {
 	PrimaryActorTick.bCanEverTick = false;
 
-	// Setup default root component
+	GridCoords = FIntPoint::ZeroValue;
+	bCanBeTriggered = true;
+	bUsesTriggerBox = true;
+	CellValue = EMineGridMapCell::MGMC_MAX;
+	PresentedCellValue = EMineGridMapCell::MGMC_MAX;
+
+	// Setup default root component, movable as cells are moved when recycled by owning grid
 	auto SceneComponent = CreateDefaultSubobject<USceneComponent>(TEXT("SceneComponent"));
-	SceneComponent->SetMobility(EComponentMobility::Static);
+	SceneComponent->SetMobility(EComponentMobility::Movable);
 	SetRootComponent(SceneComponent);
 
 	// Setup trigger box component
@@ -28,7 +34,7 @@ AMineGridCellBase::AMineGridCellBase()
 	TriggerBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 	TriggerBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Overlap);
 
-	TriggerBox->SetMobility(EComponentMobility::Static);
+	TriggerBox->SetMobility(EComponentMobility::Movable);
 
 	// Set default trigger box extent
 	TriggerBox->SetBoxExtent(FVector(200.f, 200.f, 20.f));
@@ -37,7 +43,7 @@ AMineGridCellBase::AMineGridCellBase()
 	CellMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("CellMesh"));
 	CellMesh->SetupAttachment(GetRootComponent());
 
-	CellMesh->SetMobility(EComponentMobility::Stationary);
+	CellMesh->SetMobility(EComponentMobility::Movable);
 
 	// Setup cell value text component
 	ValueText = CreateDefaultSubobject<UTextRenderComponent>(TEXT("ValueText"));
@@ -46,80 +52,127 @@ AMineGridCellBase::AMineGridCellBase()
 
 void AMineGridCellBase::UpdateCellValue(const EMineGridMapCell& NewCellValue)
 {
-	if (NewCellValue <= EMineGridMapCell::MGMC_Eight)
+	if (SetCellValue(NewCellValue))
 	{
-		if (ValueText)
-		{
-			if (NewCellValue > EMineGridMapCell::MGMC_Zero)
-			{
-				// Set cell value if not zero
-				FString NumOfMinesStr = FString::Printf(TEXT("%i"), (uint8)NewCellValue);
-				ValueText->SetText(FText::FromString(NumOfMinesStr));
-			}
-			else
-			{
-				// Set empty string if zero
-				ValueText->SetText(FText::FromString(""));
-			}
-		}
+		UpdateCellPresentation();
+	}
+}
 
-		if (ClearMaterial)
-		{
-			// Set appropriate material
-			CellMesh->SetMaterial(0, ClearMaterial);
-		}
+bool AMineGridCellBase::SetCellValue(const EMineGridMapCell NewCellValue)
+{
+	if (NewCellValue == CellValue)
+	{
+		return false;
+	}
+
+	CellValue = NewCellValue;
 
+	if (NewCellValue <= EMineGridMapCell::MGMC_Eight)
+	{
 		// No need to generate overlap events anymore so disable them to save resources
 		TriggerBox->SetGenerateOverlapEvents(false);
-	} 
-	else if (NewCellValue == EMineGridMapCell::MGMC_Revealed)
+		bCanBeTriggered = false;
+	}
+	else if (NewCellValue == EMineGridMapCell::MGMC_Undiscovered)
 	{
-		if (ValueText)
-		{
-			// Set cell value
-			FString AsteriskStr = TEXT("*");
-			ValueText->SetText(FText::FromString(AsteriskStr));
-		}
+		// Enable generation of overlap events
+		TriggerBox->SetGenerateOverlapEvents(bUsesTriggerBox);
+		bCanBeTriggered = true;
+	}
 
-		if (UntriggeredMaterial)
-		{
-			// Set appropriate material
-			CellMesh->SetMaterial(0, UntriggeredMaterial);
-		}
+	return true;
+}
+
+void AMineGridCellBase::UpdateCellPresentation()
+{
+	if (PresentedCellValue == CellValue)
+	{
+		return;
 	}
-	else if (NewCellValue == EMineGridMapCell::MGMC_Exploded)
+
+	PresentedCellValue = CellValue;
+
+	// Texts are shared, so comparing them is cheap and setting unchanged one does not dirty render state
+	const FText& NewValueText = GetCellValueText(CellValue);
+	if (ValueText && !ValueText->Text.IdenticalTo(NewValueText))
 	{
-		if (ValueText)
-		{
-			// Set cell value
-			FString AsteriskStr = TEXT("*");
-			ValueText->SetText(FText::FromString(AsteriskStr));
-		}
+		ValueText->SetText(NewValueText);
+	}
 
-		if (ExplodedMaterial)
-		{
-			// Set appropriate material
-			CellMesh->SetMaterial(0, ExplodedMaterial);
-		}
+	UMaterialInterface* NewMaterial = GetCellValueMaterial(CellValue);
+	if (NewMaterial && CellMesh->GetMaterial(0) != NewMaterial)
+	{
+		// Set appropriate material
+		CellMesh->SetMaterial(0, NewMaterial);
 	}
-	else if (NewCellValue == EMineGridMapCell::MGMC_Undiscovered)
+}
+
+const FText& AMineGridCellBase::GetCellValueText(const EMineGridMapCell Value)
+{
+	// Built once and shared by all cells, instead of formatting new text on every value change
+	static const TArray<FText> CellValueTexts = []()
 	{
-		if (ValueText)
-		{
-			// Set cell value
-			FString EmptyStr = TEXT("");
-			ValueText->SetText(FText::FromString(EmptyStr));
-		}
+		TArray<FText> Texts;
+		Texts.SetNum((int32)EMineGridMapCell::MGMC_MAX + 1);
 
-		if (UntriggeredMaterial)
+		// Surrounding mines count is shown if not zero
+		for (uint8 NumOfMines = (uint8)EMineGridMapCell::MGMC_One; NumOfMines <= (uint8)EMineGridMapCell::MGMC_Eight; NumOfMines++)
 		{
-			// Set appropriate material
-			CellMesh->SetMaterial(0, UntriggeredMaterial);
+			Texts[NumOfMines] = FText::AsCultureInvariant(FString::Printf(TEXT("%i"), NumOfMines));
 		}
 
-		// Enable generation of overlap events
-		TriggerBox->SetGenerateOverlapEvents(true);
+		Texts[(int32)EMineGridMapCell::MGMC_Revealed] = FText::AsCultureInvariant(TEXT("*"));
+		Texts[(int32)EMineGridMapCell::MGMC_Exploded] = FText::AsCultureInvariant(TEXT("*"));
+		return Texts;
+	}();
+
+	return CellValueTexts[FMath::Min((int32)Value, (int32)EMineGridMapCell::MGMC_MAX)];
+}
+
+UMaterialInterface* AMineGridCellBase::GetCellValueMaterial(const EMineGridMapCell Value) const
+{
+	if (Value <= EMineGridMapCell::MGMC_Eight)
+	{
+		return ClearMaterial;
+	}
+	else if (Value == EMineGridMapCell::MGMC_Exploded)
+	{
+		return ExplodedMaterial;
 	}
+	else if (Value == EMineGridMapCell::MGMC_Revealed || Value == EMineGridMapCell::MGMC_Undiscovered)
+	{
+		return UntriggeredMaterial;
+	}
+
+	return nullptr;
+}
+
+void AMineGridCellBase::DisableTriggerBox()
+{
+	bUsesTriggerBox = false;
+
+	TriggerBox->SetGenerateOverlapEvents(false);
+	TriggerBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
+
+void AMineGridCellBase::ActivateCell(AMineGridBase* Grid, const FIntPoint& Coords, const FVector& Location)
+{
+	OwnerGrid = Grid;
+	GridCoords = Coords;
+
+	SetActorLocation(Location, false, nullptr, ETeleportType::TeleportPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+}
+
+void AMineGridCellBase::DeactivateCell()
+{
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	OwnerGrid = nullptr;
+	GridCoords = FIntPoint::ZeroValue;
+	UpdateCellValue(EMineGridMapCell::MGMC_Undiscovered);
 }
 
 // Called when the game starts or when spawned
@@ -22,9 +22,34 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGridCell")
 	class AMineGridBase* OwnerGrid;
 
+	// Coordinates of cell in owning grid, assigned on spawn
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGridCell")
+	FIntPoint GridCoords;
+
+	// Sets cell value and presents it right away
 	UFUNCTION()
 	void UpdateCellValue(const EMineGridMapCell& NewCellValue);
 
+	// Sets cell value affecting triggering only, returning whether it changed and so presentation is to be updated
+	bool SetCellValue(const EMineGridMapCell NewCellValue);
+
+	// Updates text and material to current cell value, if not presented yet
+	void UpdateCellPresentation();
+
+	FORCEINLINE EMineGridMapCell GetCellValue() const { return CellValue; }
+
+	// Whether entering cell triggers it, being so while it is not opened
+	FORCEINLINE bool CanBeTriggered() const { return bCanBeTriggered; }
+
+	// Removes trigger box from collision, cell being triggered by owning grid instead
+	void DisableTriggerBox();
+
+	// Shows pooled cell at given coords of given grid
+	void ActivateCell(class AMineGridBase* Grid, const FIntPoint& Coords, const FVector& Location);
+
+	// Hides cell returned to pool, resetting its owner and value
+	void DeactivateCell();
+
 protected:
 	// Overlap volume to emit cell entering events
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGridCell")
@@ -50,9 +75,30 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MineGridCell")
 	class UMaterialInterface* ExplodedMaterial;
 
+	// Current value of cell
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGridCell")
+	EMineGridMapCell CellValue;
+
+	// Value text and material currently represent
+	EMineGridMapCell PresentedCellValue;
+
+	// Whether entering cell triggers it
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGridCell")
+	bool bCanBeTriggered;
+
+	// Whether trigger box emits cell entering events
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MineGridCell")
+	bool bUsesTriggerBox;
+
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Text representing given cell value, shared by all cells
+	static const FText& GetCellValueText(const EMineGridMapCell Value);
+
+	// Material representing given cell value
+	class UMaterialInterface* GetCellValueMaterial(const EMineGridMapCell Value) const;
+
 	UFUNCTION()
 	void OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
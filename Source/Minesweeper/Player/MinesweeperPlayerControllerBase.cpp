@@ -3,10 +3,13 @@
 
 #include "MinesweeperPlayerControllerBase.h"
 #include "EngineUtils.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/Character.h"
 #include "Net/UnrealNetwork.h"
 #include "Minesweeper/GameMode/MinesweeperGameModeBase.h"
 #include "Minesweeper/GameMode/MinesweeperGameStateBase.h"
 #include "Minesweeper/HUD/MinesweeperHUDBase.h"
+#include "Minesweeper/Includes/MineGridRect.h"
 
 AMinesweeperPlayerControllerBase::AMinesweeperPlayerControllerBase(): Super()
 {
@@ -19,8 +22,24 @@ AMinesweeperPlayerControllerBase::AMinesweeperPlayerControllerBase(): Super()
 	MapAreaMaxHalfSizeX = 8;
 	MapAreaMaxHalfSizeY = 5;
 
+	MapAreaPrefetchSeconds = 0.5f;
+	MapAreaMaxPrefetchCells = 4;
+	MapAreaEvictionMargin = 2;
+
 	PrevPlayerRelativeGridCoords = FIntPoint(-1, -1);
 	GridMapAreaVersion = 0;
+
+	MapAreaNetSpeedShare = 0.5f;
+	MapAreaCellNetBytes = 3;
+	LastMapAreaChangesFlushTime = 0.f;
+
+	MapAreaCellCacheCapacity = 2048;
+	bDropMapAreaCellCache = false;
+
+	MapAreaCells.OwningController = this;
+
+	// Map area follows pawn, so it is held by window reusing rows and columns it leaves
+	MineGridMapArea.InitWindow(FIntPoint(MapAreaMaxHalfSizeX * 2 + 1, MapAreaMaxHalfSizeY * 2 + 1));
 }
 
 void AMinesweeperPlayerControllerBase::NotifyGameStarted_Implementation()
@@ -58,6 +77,12 @@ void AMinesweeperPlayerControllerBase::BeginPlay()
 	{
 		// Bind to on entered coords event of grid actor
 		MineGridActor->OnCharacterTriggeredCoords.AddDynamic(this, &AMinesweeperPlayerControllerBase::HandleOnTriggeredCoords);
+
+		// Cells of map area are shown on local player's machine only
+		if (IsLocalController())
+		{
+			MineGridActor->ReserveCellPool(GetMapAreaMaxNumCells());
+		}
 	}
 	else
 	{
@@ -73,42 +98,95 @@ void AMinesweeperPlayerControllerBase::BeginPlay()
 		if (APawn* PlayerPawn = GetPawn())
 		{
 			PrevPlayerRelativeGridCoords = GetPawnRelativeLocationOfGrid(PlayerPawn, MineGridActor);
+
+			// Pawn possessed before grid actor was found
+			if (HasAuthority())
+			{
+				MineGridActor->BeginTrackingCharacter(Cast<ACharacter>(PlayerPawn));
+			}
 		}
 	}
 }
 
-void AMinesweeperPlayerControllerBase::Tick(float DeltaSeconds)
+void AMinesweeperPlayerControllerBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaSeconds);
+	Super::EndPlay(EndPlayReason);
 
 	if (AMinesweeperGameModeBase* MinesweeperGameMode = GetWorld()->GetAuthGameMode<AMinesweeperGameModeBase>())
 	{
-		const FMineGridMap& FullMineGridMap = MinesweeperGameMode->GetMineGridMap();
+		MinesweeperGameMode->RemovePlayerView(this);
+	}
 
-		// Compare grid map versions to determine if update is necessary, then proceed with update
-		const uint32& FullGridMapVersion = MinesweeperGameMode->GetMineGridMapVersion();
+	ClearAllGridCells();
+	SendMapAreaChanges(MAX_int32);
+}
 
-		if (FullGridMapVersion != GridMapAreaVersion)
-		{
-			// Update GridMapArea values
-			UpdateGridMapAreaCellValues(FullMineGridMap);
+void AMinesweeperPlayerControllerBase::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
 
-			// Update map version
-			GridMapAreaVersion = FullGridMapVersion;
+	// Cells of map area are added and removed as pawn moves, instead of checking its location every tick
+	if (USceneComponent* PawnRootComponent = InPawn ? InPawn->GetRootComponent() : nullptr)
+	{
+		PawnTransformUpdatedHandle = PawnRootComponent->TransformUpdated.AddUObject(this, &AMinesweeperPlayerControllerBase::HandleOnPawnTransformUpdated);
+	}
+
+	if (MineGridActor)
+	{
+		MineGridActor->BeginTrackingCharacter(Cast<ACharacter>(InPawn));
+	}
+}
+
+void AMinesweeperPlayerControllerBase::OnUnPossess()
+{
+	if (APawn* PlayerPawn = GetPawn())
+	{
+		if (USceneComponent* PawnRootComponent = PlayerPawn->GetRootComponent())
+		{
+			PawnRootComponent->TransformUpdated.Remove(PawnTransformUpdatedHandle);
 		}
-		else
+
+		if (MineGridActor)
 		{
-			// Add&remove marginal cells of GridMapArea as necessary
-			AddRemoveGridMapAreaCells(FullMineGridMap);
+			MineGridActor->EndTrackingCharacter(Cast<ACharacter>(PlayerPawn));
 		}
 	}
+	PawnTransformUpdatedHandle.Reset();
+
+	Super::OnUnPossess();
 }
 
-void AMinesweeperPlayerControllerBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+void AMinesweeperPlayerControllerBase::HandleOnMineGridMapUpdated(const int32 MineGridMapVersion)
 {
-	Super::EndPlay(EndPlayReason);
+	if (AMinesweeperGameModeBase* MinesweeperGameMode = GetWorld()->GetAuthGameMode<AMinesweeperGameModeBase>())
+	{
+		if (MineGridMapVersion != GridMapAreaVersion)
+		{
+			// Update GridMapArea values from changes since previous version, or from whole map if some of them are gone already
+			const FMineGridMapJournal& MineGridMapJournal = MinesweeperGameMode->GetMineGridMapJournal();
 
-	ClearAllGridCells();
+			if (MineGridMapJournal.CanReplaySince(GridMapAreaVersion, MineGridMapVersion))
+			{
+				UpdateGridMapAreaCellValuesSince(MineGridMapJournal, GridMapAreaVersion);
+			}
+			else
+			{
+				UpdateGridMapAreaCellValues(MinesweeperGameMode->GetMineGridMap());
+			}
+
+			// Update map version
+			GridMapAreaVersion = MineGridMapVersion;
+		}
+	}
+}
+
+void AMinesweeperPlayerControllerBase::HandleOnPawnTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	if (AMinesweeperGameModeBase* MinesweeperGameMode = GetWorld()->GetAuthGameMode<AMinesweeperGameModeBase>())
+	{
+		// Add&remove marginal cells of GridMapArea as pawn crosses cells
+		AddRemoveGridMapAreaCells(MinesweeperGameMode->GetMineGridMap());
+	}
 }
 
 void AMinesweeperPlayerControllerBase::AddRemoveGridMapAreaCells(const FMineGridMap& MineGridMap, bool bForcedAddRemove)
@@ -123,22 +201,34 @@ void AMinesweeperPlayerControllerBase::AddRemoveGridMapAreaCells(const FMineGrid
 			// it is forced to update, then proceed with adding & removing marginal cells if new pawn coords is different
 			if (PawnRelativeGridCoords != PrevPlayerRelativeGridCoords || bForcedAddRemove)
 			{
+				AMinesweeperGameModeBase* MinesweeperGameMode = GetWorld()->GetAuthGameMode<AMinesweeperGameModeBase>();
+
+				// Catch cells cached on owning client up with changes made out of view, so ones coming back need no sending.
+				// Forced update belongs to new game, dropping them instead, along with ones leaving area until next flush.
+				if (bForcedAddRemove)
+				{
+					MapAreaCells.RemoveEvictedCells();
+					bDropMapAreaCellCache = true;
+				}
+				else if (MinesweeperGameMode)
+				{
+					HandleOnMineGridMapUpdated(MinesweeperGameMode->GetMineGridMapVersion());
+				}
+
 				// Define reference to grid map dimensions
 				const FIntPoint& MapGridDimensions = MineGridMap.GridDimensions;
 
 				// Determine starting & endings coords of map area
+				// extending them ahead of pawn as far as it gets within prefetch time
 				const FIntPoint MapAreaMaxHalfSize = FIntPoint(MapAreaMaxHalfSizeX, MapAreaMaxHalfSizeY);
+				const FIntPoint PrefetchCells = GetMapAreaPrefetchCells(PlayerPawn);
 				const FIntRect MaxBounds(
-					PawnRelativeGridCoords - MapAreaMaxHalfSize, 
-					PawnRelativeGridCoords + MapAreaMaxHalfSize
+					PawnRelativeGridCoords - MapAreaMaxHalfSize + FIntPoint(FMath::Min(PrefetchCells.X, 0), FMath::Min(PrefetchCells.Y, 0)), 
+					PawnRelativeGridCoords + MapAreaMaxHalfSize + FIntPoint(FMath::Max(PrefetchCells.X, 0), FMath::Max(PrefetchCells.Y, 0))
 				);
 
-				// Allocate max size of authoritive mines area
-				const FIntPoint MapAreaMaxSize = MaxBounds.Size() + FIntPoint(1, 1);
-				MineGridMapArea.Cells.Reserve(MapAreaMaxSize.X * MapAreaMaxSize.Y);
-
 				// Determine valid starting & endings coords of map "visible" area
-				const FIntRect NewBounds(
+				FIntRect NewBounds(
 					FIntPoint(
 						MaxBounds.Min.X >= 0 ? MaxBounds.Min.X : FMath::Min(0, MaxBounds.Max.X + 1),
 						MaxBounds.Min.Y >= 0 ? MaxBounds.Min.Y : FMath::Min(0, MaxBounds.Max.Y + 1)
@@ -152,169 +242,106 @@ void AMinesweeperPlayerControllerBase::AddRemoveGridMapAreaCells(const FMineGrid
 				// Retrieve old starting & endings coords of map area
 				const FIntRect OldBounds(MineGridMapArea.StartCoords, MineGridMapArea.EndCoords);
 
-				// Start and end coords here are inclusive here
-				const FIntPoint MapAreaSize = NewBounds.Size() + FIntPoint(1, 1);
-
-				//
-				// Start of side bounds calculation. Calculation is performed on each side by iterating each of them.
-				// 
-				// Old and new bounds are going to be rotated around new bounds center so every side ends at the left edge where 
-				// comparison takes place for calculation. Then result of side calculation are going to be rotated back to map orientation.
-				// 
-
-				// Prepare rotated bounds which are [Min, Max)
-				FBox2D RotatedNewBounds = FBox2D(NewBounds.Min, NewBounds.Max+1);
-				FBox2D RotatedOldBounds = FBox2D(OldBounds.Min, OldBounds.Max+1);
-
-				// Prepare center and extents of both new and old bounds for calculation needs
-				FVector2D NewBoundsCenter, NewBoundsExtents;
-				RotatedNewBounds.GetCenterAndExtents(NewBoundsCenter, NewBoundsExtents);
-
-				FVector2D OldBoundsCenter, OldBoundsExtents;
-				RotatedOldBounds.GetCenterAndExtents(OldBoundsCenter, OldBoundsExtents);
-
-				// Prepare rotated new and old bounds extents for performing rotating transformation on
-				FVector2D RotatedNewBoundsExtents = NewBoundsExtents;
-
-				FVector2D RotatedOldBoundsCenter = OldBoundsCenter;
-				FVector2D RotatedOldBoundsExtents = OldBoundsExtents;
+				// Keep old cells within eviction margin of new area, so pawn crossing cell border back and forth does not churn them.
+				// Forced update snaps to exact area, as grid map may have changed.
+				if (!bForcedAddRemove && MapAreaEvictionMargin > 0 && !MineGridRect::IsEmpty(NewBounds))
+				{
+					const FIntPoint EvictionMargin(MapAreaEvictionMargin, MapAreaEvictionMargin);
+					const FIntRect RetentionBounds(NewBounds.Min - EvictionMargin, NewBounds.Max + EvictionMargin);
 
-				// Prepare rotated side bounds, center and extents for storing result of side calculation in currently iterating orientation
-				FBox2D SideBounds;
-				FVector2D SideBoundsExtents, SideBoundsCenter;
+					NewBounds = MineGridRect::Bounds(NewBounds, MineGridRect::Intersection(OldBounds, RetentionBounds));
+				}
 
-				// Rotation matrix to do 90 degrees turn as circular "increment" of iteration
-				const FMatrix2x2 RotationMatrix(
-					0, 1,
-					-1, 0
-				);
-				// Being used for rotating result of side calculation back to map orientation
-				FMatrix2x2 AccumulatedRotationMatrix = FMatrix2x2();
+				// Start and end coords here are inclusive here
+				const FIntPoint MapAreaSize = NewBounds.Size() + FIntPoint(1, 1);
 
-				// Store all calculated sides rotated back to map orientation in relievant collections for cells processing within them. 
-				// Each element are end-inclusive.
-				TArray<FIntRect> AdditiveSides;
+				// Cells leaving and entering map area, as disjoint end-inclusive rects, so every cell is emitted once
 				TArray<FIntRect> SubtractiveSides;
-				AdditiveSides.Reserve(4);
+				TArray<FIntRect> AdditiveSides;
 				SubtractiveSides.Reserve(4);
+				AdditiveSides.Reserve(4);
 
-				do {
-					// Calculate difference on left edge of at time rotated old and new bounds
-					const FVector2D DiffMin = RotatedOldBounds.Min - RotatedNewBounds.Min;
-
-					if (DiffMin.X != 0)
-					{
-						bool bIsAdditive = DiffMin.X > 0,
-								 bIsSubstractive = DiffMin.X < 0;
-
-						if (bIsAdditive)
-						{
-							SideBounds.Min = FVector2D(RotatedNewBounds.Min);
-							SideBounds.Max = FVector2D(RotatedNewBounds.Min.X + DiffMin.X, RotatedNewBounds.Max.Y);
-						}
-						else if (bIsSubstractive)
-						{
-							SideBounds.Min = FVector2D(RotatedOldBounds.Min);
-							SideBounds.Max = FVector2D(RotatedOldBounds.Min.X - DiffMin.X, RotatedOldBounds.Max.Y);
-						}
-
-						// Rotate newly calculated side bounds to match map orientation
-						SideBounds.GetCenterAndExtents(SideBoundsCenter, SideBoundsExtents);
-
-						SideBoundsCenter = AccumulatedRotationMatrix.TransformPoint(SideBoundsCenter - NewBoundsCenter) + NewBoundsCenter;
-						SideBoundsExtents = AccumulatedRotationMatrix.TransformPoint(SideBoundsExtents).GetAbs();
-
-						SideBounds.Min = (SideBoundsCenter - SideBoundsExtents);
-						SideBounds.Max = (SideBoundsCenter + SideBoundsExtents);
-
-						// Add ready side bounds to collection
-						if (bIsAdditive)
-						{
-							AdditiveSides.Emplace(SideBounds.Min.IntPoint(), SideBounds.Max.IntPoint()-1);
-						}
-						else if (bIsSubstractive) 
-						{
-							SubtractiveSides.Emplace(SideBounds.Min.IntPoint(), SideBounds.Max.IntPoint()-1);
-						}
-					}
-
-					// Rotate new bounds
-					RotatedNewBoundsExtents = RotationMatrix.TransformPoint(RotatedNewBoundsExtents).GetAbs();
-
-					RotatedNewBounds.Min = (NewBoundsCenter - RotatedNewBoundsExtents);
-					RotatedNewBounds.Max = (NewBoundsCenter + RotatedNewBoundsExtents);
-
-					// Rotate old bounds around new bounds center
-					RotatedOldBoundsCenter = RotationMatrix.TransformPoint(RotatedOldBoundsCenter - NewBoundsCenter) + NewBoundsCenter;
-					RotatedOldBoundsExtents = RotationMatrix.TransformPoint(RotatedOldBoundsExtents).GetAbs();
-
-					RotatedOldBounds.Min = (RotatedOldBoundsCenter - RotatedOldBoundsExtents);
-					RotatedOldBounds.Max = (RotatedOldBoundsCenter + RotatedOldBoundsExtents);
-
-					AccumulatedRotationMatrix = AccumulatedRotationMatrix.Concatenate(RotationMatrix.Inverse());
-				}
-				while (!AccumulatedRotationMatrix.IsIdentity());	// Until reaches map orientation
+				MineGridRect::Difference(OldBounds, NewBounds, SubtractiveSides);
+				MineGridRect::Difference(NewBounds, OldBounds, AdditiveSides);
 
 				// Define removed & added cell containers
 				FMineGridMapChanges GridMapChanges;
 				GridMapChanges.NewGridDimensions = MapAreaSize;
 
-				// Process subtractive bounds
-				for (const auto &SubtractiveBounds : SubtractiveSides)
+				int32 NumRemovedCells = 0;
+				for (const FIntRect& SubtractiveBounds : SubtractiveSides)
 				{
-					if (AdditiveSides.Contains(SubtractiveBounds))
-					{
-						continue;
-					}
+					NumRemovedCells += MineGridRect::NumCells(SubtractiveBounds);
+				}
+				GridMapChanges.RemovedGridMapCells.Reserve(NumRemovedCells);
 
+				int32 NumAddedCells = 0;
+				for (const FIntRect& AdditiveBounds : AdditiveSides)
+				{
+					NumAddedCells += MineGridRect::NumCells(AdditiveBounds);
+				}
+				GridMapChanges.AddedGridMapCellCoords.Reserve(NumAddedCells);
+				GridMapChanges.AddedGridMapCellValues.Reserve(NumAddedCells);
+
+				// Process subtractive bounds
+				for (const FIntRect& SubtractiveBounds : SubtractiveSides)
+				{
 					for (int32 Y = SubtractiveBounds.Min.Y; Y <= SubtractiveBounds.Max.Y; ++Y)
 					{
 						for (int32 X = SubtractiveBounds.Min.X; X <= SubtractiveBounds.Max.X; ++X)
 						{
-							FIntPoint Coords(X, Y);
-
-							GridMapChanges.RemovedGridMapCells.AddUnique(Coords);
+							GridMapChanges.RemovedGridMapCells.Emplace(X, Y);
 						}
 					}
 				}
 
-				// Then additive bounds
-				for (const auto &AdditiveBounds : AdditiveSides)
+				// Map area values are updated only as game mode changes cells inside of it. Set before reading added cells,
+				// as mines coming into view after game over get revealed.
+				if (MinesweeperGameMode)
 				{
-					if (SubtractiveSides.Contains(AdditiveBounds))
-					{
-						continue;
-					}
+					MinesweeperGameMode->SetPlayerViewBounds(this, NewBounds);
+				}
 
+				// Then additive bounds
+				for (const FIntRect& AdditiveBounds : AdditiveSides)
+				{
 					for (int32 Y = AdditiveBounds.Min.Y; Y <= AdditiveBounds.Max.Y; ++Y)
 					{
 						for (int32 X = AdditiveBounds.Min.X; X <= AdditiveBounds.Max.X; ++X)
 						{
 							FIntPoint Coords(X, Y);
 
-							if (!MineGridMap.Cells.Contains(Coords))
+							EMineGridMapCell CellValue;
+							if (!MineGridMap.TryGetCell(Coords, CellValue))
 							{
 								continue;
 							}
-							EMineGridMapCell CellValue = MineGridMap.Cells[Coords];
 
-							if (!GridMapChanges.AddedGridMapCellCoords.Contains(Coords))
-							{
-								GridMapChanges.AddedGridMapCellCoords.Add(Coords);
-								GridMapChanges.AddedGridMapCellValues.Add(CellValue);
-							}
+							GridMapChanges.AddedGridMapCellCoords.Add(Coords);
+							GridMapChanges.AddedGridMapCellValues.Add(CellValue);
 						}
 					}
 				}
 
+				// Grow window of map area while its cells are still inside of old bounds
+				MineGridMapArea.ReserveWindow(MapAreaSize);
+
 				MineGridMapArea.GridDimensions = MapAreaSize;
 				MineGridMapArea.StartCoords = NewBounds.Min;
 				MineGridMapArea.EndCoords = NewBounds.Max;
 
-				// Finally apply changes by making RPC so they update their own grid map areas 
-				// as a workaround of Unreal not supporting containers replication
+				MapAreaBounds.StartCoords = NewBounds.Min;
+				MapAreaBounds.EndCoords = NewBounds.Max;
+
+				// Finally apply changes, owning client receiving them through replicated map area cells
 				ApplyAddedRemovedGridCells(GridMapChanges);
 
+				// Catch up with mines revealed as area came into view after game over, not sent while area was moving
+				if (MinesweeperGameMode && !bForcedAddRemove)
+				{
+					HandleOnMineGridMapUpdated(MinesweeperGameMode->GetMineGridMapVersion());
+				}
+
 				// Remember player coords for next time
 				PrevPlayerRelativeGridCoords = PawnRelativeGridCoords;
 			}
@@ -322,17 +349,23 @@ void AMinesweeperPlayerControllerBase::AddRemoveGridMapAreaCells(const FMineGrid
 	}
 }
 
+TMap<FIntPoint, EMineGridMapCell> AMinesweeperPlayerControllerBase::GetMineGridMapAreaCells() const
+{
+	TMap<FIntPoint, EMineGridMapCell> CellsView;
+	MineGridMapArea.ExportCells(CellsView);
+
+	return CellsView;
+}
+
 void AMinesweeperPlayerControllerBase::ClearAllGridCells()
 {
 	FMineGridMapChanges GridMapChanges;
 	GridMapChanges.NewGridDimensions = FIntPoint::ZeroValue;
 
-	for (auto CellToRemove : MineGridMapArea.Cells)
+	MineGridMapArea.ForEachCell([&GridMapChanges](const FIntPoint& CoordsToRemoveAt, const EMineGridMapCell CellValue)
 	{
-		const FIntPoint CoordsToRemoveAt = CellToRemove.Key;
-
-		GridMapChanges.RemovedGridMapCells.AddUnique(CoordsToRemoveAt);
-	}
+		GridMapChanges.RemovedGridMapCells.Emplace(CoordsToRemoveAt);
+	});
 
 	ApplyAddedRemovedGridCells(GridMapChanges);
 }
@@ -341,18 +374,59 @@ void AMinesweeperPlayerControllerBase::UpdateGridMapAreaCellValues(const FMineGr
 {
 	FMineGridMapCellUpdates CellsUpdate;
 
-	for (TPair<FIntPoint, EMineGridMapCell>& CoordsCellEntry : MineGridMapArea.Cells)
+	MineGridMapArea.ForEachCell([&MineGridMap, &CellsUpdate](const FIntPoint& Coords, const EMineGridMapCell CellValue)
 	{
-		const FIntPoint Coords = CoordsCellEntry.Key;
-		const EMineGridMapCell NewCellValue = MineGridMap.Cells[Coords];
+		const EMineGridMapCell NewCellValue = MineGridMap.GetCell(Coords);
 
-		if (CoordsCellEntry.Value != NewCellValue)
+		if (CellValue != NewCellValue)
 		{
 			CellsUpdate.UpdatedGridMapCellCoords.Emplace(Coords);
 			CellsUpdate.UpdatedGridMapCellValues.Emplace(NewCellValue);
 		}
+	});
+
+	if (CellsUpdate.UpdatedGridMapCellCoords.Num() > 0)
+	{
+		ApplyUpdatedGridCellValues(CellsUpdate);
 	}
 
+	// Catch up cells cached on owning client as well
+	TArray<TPair<FIntPoint, EMineGridMapCell>> CachedCellUpdates;
+	MapAreaCells.ForEachCell([this, &MineGridMap, &CachedCellUpdates](const FIntPoint& Coords, const EMineGridMapCell CellValue)
+	{
+		EMineGridMapCell NewCellValue;
+		if (!MineGridMapArea.HasCell(Coords) && MineGridMap.TryGetCell(Coords, NewCellValue) && CellValue != NewCellValue)
+		{
+			CachedCellUpdates.Emplace(Coords, NewCellValue);
+		}
+	});
+
+	for (const TPair<FIntPoint, EMineGridMapCell>& CachedCellUpdate : CachedCellUpdates)
+	{
+		MapAreaCells.UpdateCell(CachedCellUpdate.Key, CachedCellUpdate.Value);
+	}
+}
+
+void AMinesweeperPlayerControllerBase::UpdateGridMapAreaCellValuesSince(const FMineGridMapJournal& MineGridMapJournal, const int32 SinceVersion)
+{
+	FMineGridMapCellUpdates CellsUpdate;
+
+	MineGridMapJournal.ForEachSince(SinceVersion, [this, &CellsUpdate](const FIntPoint& Coords, const EMineGridMapCell NewCellValue)
+	{
+		// Skip changes outside of area, except of cells cached on owning client
+		EMineGridMapCell CellValue;
+		const bool bHasCell = MineGridMapArea.TryGetCell(Coords, CellValue);
+		if (bHasCell && CellValue != NewCellValue)
+		{
+			CellsUpdate.UpdatedGridMapCellCoords.Emplace(Coords);
+			CellsUpdate.UpdatedGridMapCellValues.Emplace(NewCellValue);
+		}
+		else if (!bHasCell)
+		{
+			MapAreaCells.UpdateCell(Coords, NewCellValue);
+		}
+	});
+
 	if (CellsUpdate.UpdatedGridMapCellCoords.Num() > 0)
 	{
 		ApplyUpdatedGridCellValues(CellsUpdate);
@@ -366,10 +440,15 @@ void AMinesweeperPlayerControllerBase::HandleOnTriggeredCoords(const FIntPoint&
 
 void AMinesweeperPlayerControllerBase::SelectNewGame_Implementation(const uint8 MapSize)
 {
-	OnPlayerNewGame.Broadcast(MapSize);
+	OnPlayerNewGame.Broadcast(MapSize, 0, 0.0f);
+}
+
+void AMinesweeperPlayerControllerBase::SelectNewSeededGame_Implementation(const uint8 MapSize, const int32 Seed, const float MineDensity)
+{
+	OnPlayerNewGame.Broadcast(MapSize, Seed, MineDensity);
 }
 
-void AMinesweeperPlayerControllerBase::ApplyAddedRemovedGridCells_Implementation(const FMineGridMapChanges& GridMapChanges)
+void AMinesweeperPlayerControllerBase::ApplyAddedRemovedGridCells(const FMineGridMapChanges& GridMapChanges)
 {
 	// 
 	// 1. Update area of map according to new changes
@@ -377,40 +456,286 @@ void AMinesweeperPlayerControllerBase::ApplyAddedRemovedGridCells_Implementation
 
 	for (const FIntPoint& RemovedCellCoords : GridMapChanges.RemovedGridMapCells)
 	{
-		MineGridMapArea.Cells.Remove(RemovedCellCoords);
+		MineGridMapArea.RemoveCell(RemovedCellCoords);
 	}
 
 	auto AddedCoordsIt = GridMapChanges.AddedGridMapCellCoords.CreateConstIterator();
 	auto AddedValuesIt = GridMapChanges.AddedGridMapCellValues.CreateConstIterator();
 	for (AddedCoordsIt, AddedValuesIt; AddedCoordsIt && AddedValuesIt; ++AddedCoordsIt, ++AddedValuesIt)
 	{
-		MineGridMapArea.Cells.Emplace(*AddedCoordsIt, *AddedValuesIt);
+		MineGridMapArea.SetCell(*AddedCoordsIt, *AddedValuesIt);
 	}
 
 	// 
-	// 2. Update visible representation of area
+	// 2. Update visible representation of area, merging changes until next flush on server
 	//
-	if (MineGridActor)
+	if (HasAuthority())
+	{
+		PendingMapAreaChanges.Append(GridMapChanges);
+		ScheduleMapAreaChangesFlush();
+	}
+	else if (MineGridActor)
 	{
 		MineGridActor->AddOrRemoveGridCells(GridMapChanges);
 	}
 }
 
-void AMinesweeperPlayerControllerBase::ApplyUpdatedGridCellValues_Implementation(const FMineGridMapCellUpdates& UpdatedCells)
+void AMinesweeperPlayerControllerBase::ApplyUpdatedGridCellValues(const FMineGridMapCellUpdates& UpdatedCells)
 {
 	auto UpdatedCoordsIt = UpdatedCells.UpdatedGridMapCellCoords.CreateConstIterator();
 	auto UpdatedValuesIt = UpdatedCells.UpdatedGridMapCellValues.CreateConstIterator();
 	for (UpdatedCoordsIt, UpdatedValuesIt; UpdatedCoordsIt && UpdatedValuesIt; ++UpdatedCoordsIt, ++UpdatedValuesIt)
 	{
-		MineGridMapArea.Cells[*UpdatedCoordsIt] = *UpdatedValuesIt;
+		MineGridMapArea.SetCell(*UpdatedCoordsIt, *UpdatedValuesIt);
 	}
 
-	if (MineGridActor)
+	if (HasAuthority())
+	{
+		PendingMapAreaChanges.Append(UpdatedCells);
+		ScheduleMapAreaChangesFlush();
+	}
+	else if (MineGridActor)
 	{
 		MineGridActor->UpdateCellValues(UpdatedCells);
 	}
 }
 
+void AMinesweeperPlayerControllerBase::HandleOnMapAreaCellsReplicated(const TArray<FIntPoint>& ReplicatedCells)
+{
+	FMineGridMapChanges GridMapChanges;
+	GridMapChanges.NewGridDimensions = MineGridMapArea.GridDimensions;
+
+	FMineGridMapCellUpdates CellsUpdate;
+
+	for (const FIntPoint& Coords : ReplicatedCells)
+	{
+		const EMineGridMapCell NewCellValue = MapAreaCells.ReplicatedCells.FindChecked(Coords);
+
+		EMineGridMapCell CellValue;
+		if (MineGridMapArea.TryGetCell(Coords, CellValue))
+		{
+			if (CellValue != NewCellValue)
+			{
+				CellsUpdate.UpdatedGridMapCellCoords.Emplace(Coords);
+				CellsUpdate.UpdatedGridMapCellValues.Emplace(NewCellValue);
+			}
+		}
+		else if (MineGridMapArea.IsValidCoords(Coords))
+		{
+			GridMapChanges.AddedGridMapCellCoords.Emplace(Coords);
+			GridMapChanges.AddedGridMapCellValues.Emplace(NewCellValue);
+		}
+	}
+
+	if (GridMapChanges.AddedGridMapCellCoords.Num() > 0)
+	{
+		ApplyAddedRemovedGridCells(GridMapChanges);
+	}
+
+	if (CellsUpdate.UpdatedGridMapCellCoords.Num() > 0)
+	{
+		ApplyUpdatedGridCellValues(CellsUpdate);
+	}
+}
+
+void AMinesweeperPlayerControllerBase::HandleOnMapAreaCellsRemoved(const TArray<FIntPoint>& RemovedCells)
+{
+	FMineGridMapChanges GridMapChanges;
+	GridMapChanges.NewGridDimensions = MineGridMapArea.GridDimensions;
+
+	for (const FIntPoint& Coords : RemovedCells)
+	{
+		if (MineGridMapArea.HasCell(Coords))
+		{
+			GridMapChanges.RemovedGridMapCells.Emplace(Coords);
+		}
+	}
+
+	if (GridMapChanges.RemovedGridMapCells.Num() > 0)
+	{
+		ApplyAddedRemovedGridCells(GridMapChanges);
+	}
+}
+
+void AMinesweeperPlayerControllerBase::OnRep_MapAreaBounds(const FMineGridMapAreaBounds& OldMapAreaBounds)
+{
+	const FIntRect OldBounds = OldMapAreaBounds.ToRect();
+	const FIntRect NewBounds = MapAreaBounds.ToRect();
+
+	TArray<FIntRect> SubtractiveSides;
+	TArray<FIntRect> AdditiveSides;
+	MineGridRect::Difference(OldBounds, NewBounds, SubtractiveSides);
+	MineGridRect::Difference(NewBounds, OldBounds, AdditiveSides);
+
+	FMineGridMapChanges GridMapChanges;
+	GridMapChanges.NewGridDimensions = NewBounds.Size() + FIntPoint(1, 1);
+
+	// Hide cells leaving area, looked up while they are still inside of old bounds
+	for (const FIntRect& SubtractiveBounds : SubtractiveSides)
+	{
+		for (int32 Y = SubtractiveBounds.Min.Y; Y <= SubtractiveBounds.Max.Y; ++Y)
+		{
+			for (int32 X = SubtractiveBounds.Min.X; X <= SubtractiveBounds.Max.X; ++X)
+			{
+				if (MineGridMapArea.HasCell(FIntPoint(X, Y)))
+				{
+					GridMapChanges.RemovedGridMapCells.Emplace(X, Y);
+				}
+			}
+		}
+	}
+
+	MineGridMapArea.ReserveWindow(GridMapChanges.NewGridDimensions);
+	MineGridMapArea.GridDimensions = GridMapChanges.NewGridDimensions;
+	MineGridMapArea.StartCoords = NewBounds.Min;
+	MineGridMapArea.EndCoords = NewBounds.Max;
+
+	// Replicated cells alias the same way as cells held on server, their windows being sized the same
+	MapAreaCells.ItemIndices.Reserve(GridMapChanges.NewGridDimensions * 2);
+	MapAreaCells.ReplicatedCells.Reserve(GridMapChanges.NewGridDimensions * 2);
+
+	// Show cells entering area right away if they are cached or were replicated along with bounds, the rest following as they are replicated
+	for (const FIntRect& AdditiveBounds : AdditiveSides)
+	{
+		for (int32 Y = AdditiveBounds.Min.Y; Y <= AdditiveBounds.Max.Y; ++Y)
+		{
+			for (int32 X = AdditiveBounds.Min.X; X <= AdditiveBounds.Max.X; ++X)
+			{
+				if (const EMineGridMapCell* CellValue = MapAreaCells.ReplicatedCells.Find(FIntPoint(X, Y)))
+				{
+					GridMapChanges.AddedGridMapCellCoords.Emplace(X, Y);
+					GridMapChanges.AddedGridMapCellValues.Emplace(*CellValue);
+				}
+			}
+		}
+	}
+
+	ApplyAddedRemovedGridCells(GridMapChanges);
+}
+
+void AMinesweeperPlayerControllerBase::ScheduleMapAreaChangesFlush()
+{
+	FTimerManager& TimerManager = GetWorldTimerManager();
+	if (!TimerManager.IsTimerActive(FlushMapAreaChangesTimerHandle))
+	{
+		// Flush at most once per net update, so changes of several cell openings in between go out together
+		const float FlushInterval = NetUpdateFrequency > 0.f ? 1.f / NetUpdateFrequency : 0.f;
+		TimerManager.SetTimer(FlushMapAreaChangesTimerHandle, this, &AMinesweeperPlayerControllerBase::FlushMapAreaChanges, FMath::Max(FlushInterval, KINDA_SMALL_NUMBER), false);
+	}
+}
+
+int32 AMinesweeperPlayerControllerBase::GetMapAreaChangesFlushBudget() const
+{
+	// Local player takes everything at once
+	UNetConnection* Connection = GetNetConnection();
+	if (IsLocalController() || !Connection)
+	{
+		return MAX_int32;
+	}
+
+	// Budget covers time since previous flush, but no more than few net updates so it does not burst after idling
+	const float FlushInterval = NetUpdateFrequency > 0.f ? 1.f / NetUpdateFrequency : 0.f;
+	const float BudgetSeconds = FMath::Clamp(GetWorld()->GetTimeSeconds() - LastMapAreaChangesFlushTime, FlushInterval, 4.f * FlushInterval + KINDA_SMALL_NUMBER);
+
+	const float BudgetBytes = Connection->CurrentNetSpeed * MapAreaNetSpeedShare * BudgetSeconds;
+	return FMath::Max(1, FMath::FloorToInt(BudgetBytes / FMath::Max(MapAreaCellNetBytes, 1)));
+}
+
+void AMinesweeperPlayerControllerBase::FlushMapAreaChanges()
+{
+	SendMapAreaChanges(GetMapAreaChangesFlushBudget());
+}
+
+void AMinesweeperPlayerControllerBase::SendMapAreaChanges(const int32 MaxNumCells)
+{
+	GetWorldTimerManager().ClearTimer(FlushMapAreaChangesTimerHandle);
+
+	if (PendingMapAreaChanges.IsEmpty())
+	{
+		return;
+	}
+
+	// Cells under and ahead of pawn go first, the rest staying pending for next flushes
+	FVector2D PawnHeading = FVector2D::ZeroVector;
+	if (APawn* PlayerPawn = GetPawn())
+	{
+		PawnHeading = FVector2D(PlayerPawn->GetVelocity().GetSafeNormal2D());
+	}
+
+	FMineGridMapChanges GridMapChanges;
+	FMineGridMapCellUpdates CellUpdates;
+	PendingMapAreaChanges.ConsumeNearest(PrevPlayerRelativeGridCoords, PawnHeading, MaxNumCells, GridMapChanges, CellUpdates);
+
+	LastMapAreaChangesFlushTime = GetWorld()->GetTimeSeconds();
+
+	if (!PendingMapAreaChanges.IsEmpty())
+	{
+		ScheduleMapAreaChangesFlush();
+	}
+
+	if (GridMapChanges.RemovedGridMapCells.Num() > 0 || GridMapChanges.AddedGridMapCellCoords.Num() > 0)
+	{
+		if (MineGridActor)
+		{
+			MineGridActor->AddOrRemoveGridCells(GridMapChanges);
+		}
+
+		// Mirror changes to owning client. Window of held cells covers twice the map area, so cells left behind
+		// stay cached until cells entering area take their slots.
+		MapAreaCells.ItemIndices.Reserve(GridMapChanges.NewGridDimensions * 2);
+
+		for (const FIntPoint& RemovedCellCoords : GridMapChanges.RemovedGridMapCells)
+		{
+			MapAreaCells.EvictCell(RemovedCellCoords, MapAreaCellCacheCapacity);
+		}
+
+		if (bDropMapAreaCellCache)
+		{
+			MapAreaCells.RemoveEvictedCells();
+			bDropMapAreaCellCache = false;
+		}
+
+		for (int32 AddedIndex = 0; AddedIndex < GridMapChanges.AddedGridMapCellCoords.Num(); AddedIndex++)
+		{
+			MapAreaCells.AddCell(GridMapChanges.AddedGridMapCellCoords[AddedIndex], GridMapChanges.AddedGridMapCellValues[AddedIndex]);
+		}
+	}
+
+	if (CellUpdates.UpdatedGridMapCellCoords.Num() > 0)
+	{
+		if (MineGridActor)
+		{
+			MineGridActor->UpdateCellValues(CellUpdates);
+		}
+
+		for (int32 UpdatedIndex = 0; UpdatedIndex < CellUpdates.UpdatedGridMapCellCoords.Num(); UpdatedIndex++)
+		{
+			MapAreaCells.UpdateCell(CellUpdates.UpdatedGridMapCellCoords[UpdatedIndex], CellUpdates.UpdatedGridMapCellValues[UpdatedIndex]);
+		}
+	}
+}
+
+FIntPoint AMinesweeperPlayerControllerBase::GetMapAreaPrefetchCells(APawn* PlayerPawn) const
+{
+	const float CellSize = MineGridActor ? MineGridActor->GetCellSize() : 0.f;
+	if (CellSize <= 0.f)
+	{
+		return FIntPoint::ZeroValue;
+	}
+
+	const FVector PrefetchDistance = PlayerPawn->GetVelocity() * MapAreaPrefetchSeconds / CellSize;
+	return FIntPoint(
+		FMath::Clamp(FMath::RoundToInt(PrefetchDistance.X), -(int32)MapAreaMaxPrefetchCells, (int32)MapAreaMaxPrefetchCells),
+		FMath::Clamp(FMath::RoundToInt(PrefetchDistance.Y), -(int32)MapAreaMaxPrefetchCells, (int32)MapAreaMaxPrefetchCells)
+	);
+}
+
+int32 AMinesweeperPlayerControllerBase::GetMapAreaMaxNumCells() const
+{
+	const int32 Extension = MapAreaMaxPrefetchCells + 2 * MapAreaEvictionMargin;
+	return (2 * MapAreaMaxHalfSizeX + 1 + Extension) * (2 * MapAreaMaxHalfSizeY + 1 + Extension);
+}
+
 AMineGridBase* AMinesweeperPlayerControllerBase::FindMineGridActor()
 {
 	UWorld* World = GetWorld();
@@ -447,4 +772,6 @@ void AMinesweeperPlayerControllerBase::GetLifetimeReplicatedProps(TArray<FLifeti
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(AMinesweeperPlayerControllerBase, bIsLobbyLeader);
+	DOREPLIFETIME_CONDITION(AMinesweeperPlayerControllerBase, MapAreaCells, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(AMinesweeperPlayerControllerBase, MapAreaBounds, COND_OwnerOnly);
 }
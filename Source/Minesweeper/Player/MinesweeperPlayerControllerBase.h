@@ -5,11 +5,14 @@
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
 #include "Minesweeper/Includes/MineGridMap.h"
+#include "Minesweeper/Includes/MineGridMapAreaCells.h"
+#include "Minesweeper/Includes/MineGridMapJournal.h"
+#include "Minesweeper/Includes/MineGridMapPendingChanges.h"
 #include "Minesweeper/MineGrid/MineGridBase.h"
 
 #include "MinesweeperPlayerControllerBase.generated.h"
 
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPlayerNewGameDelegate, const uint8, MapSize);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnPlayerNewGameDelegate, const uint8, MapSize, const int32, Seed, const float, MineDensity);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPlayerTriggeredCoordsDelegate, const FIntPoint&, EnteredIntoCoords);
 
 /**
@@ -33,6 +36,12 @@ public:
 	FORCEINLINE const bool GetIsLobbyLeader() { return bIsLobbyLeader; }
 	FORCEINLINE const void SetIsLobbyLeader(bool value) { bIsLobbyLeader = value; }
 
+	FORCEINLINE const FMineGridMap& GetMineGridMapArea() const { return MineGridMapArea; }
+
+	/** Builds coords to value view of map area, as map area itself holds cells in window */
+	UFUNCTION(BlueprintPure, Category = "Minesweeper")
+	TMap<FIntPoint, EMineGridMapCell> GetMineGridMapAreaCells() const;
+
 	UFUNCTION()
 	void AddRemoveGridMapAreaCells(const FMineGridMap& MineGridMap, bool bForcedAddRemove = false);
 
@@ -42,6 +51,33 @@ public:
 	UFUNCTION()
 	void UpdateGridMapAreaCellValues(const FMineGridMap& MineGridMap);
 
+	/** Updates cell values of map area from journal changes made after given version */
+	void UpdateGridMapAreaCellValuesSince(const FMineGridMapJournal& MineGridMapJournal, const int32 SinceVersion);
+
+	/** Catches map area values up with given version of full grid map */
+	void HandleOnMineGridMapUpdated(const int32 MineGridMapVersion);
+
+	/** Marks map area values being in line with given version of full grid map, as they were just read from it */
+	FORCEINLINE void SetGridMapAreaVersion(const int32 MineGridMapVersion) { GridMapAreaVersion = MineGridMapVersion; }
+
+	/** Applies cells entering and leaving map area, their representation and owning client following on next flush on server */
+	void ApplyAddedRemovedGridCells(const FMineGridMapChanges& GridMapChanges);
+
+	/** Applies new values of map area cells, their representation and owning client following on next flush on server */
+	void ApplyUpdatedGridCellValues(const FMineGridMapCellUpdates& GridMapChanges);
+
+	/**
+	 * Shows replicated cells inside of map area on client. Cells replicated along with new bounds, before they are applied,
+	 * are shown once they are, as cells entering area.
+	 */
+	void HandleOnMapAreaCellsReplicated(const TArray<FIntPoint>& ReplicatedCells);
+
+	/** Hides cells no longer replicated on client */
+	void HandleOnMapAreaCellsRemoved(const TArray<FIntPoint>& RemovedCells);
+
+	/** Sends out pending map area changes to grid actor and owning client, as many as net speed budget allows */
+	void FlushMapAreaChanges();
+
 	UFUNCTION(Client, Reliable)
 	void NotifyGameStarted();
 
@@ -67,10 +103,28 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Minesweeper|Grid")
 	AMineGridBase* MineGridActor;
 
-	/** Defines the "visible" part of mine grid map */
+	/** Defines the "visible" part of mine grid map. Its cells are viewed by GetMineGridMapAreaCells, being held in window. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Minesweeper|Grid")
 	FMineGridMap MineGridMapArea;
 
+	/** Cells of map area replicated to owning client only */
+	UPROPERTY(Replicated)
+	FMineGridMapAreaCells MapAreaCells;
+
+	/** Bounds of map area, replicated to owning client only, which shows replicated cells inside of them */
+	UPROPERTY(ReplicatedUsing = OnRep_MapAreaBounds)
+	FMineGridMapAreaBounds MapAreaBounds;
+
+	/**
+	 * Max number of cells kept replicated to owning client after leaving map area, so coming back costs nothing.
+	 * Cells are also dropped once cells entering area take their window slots.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Minesweeper|Net", meta = (ClampMin = "0"))
+	int32 MapAreaCellCacheCapacity;
+
+	/** Whether cells cached on owning client are to be dropped on next flush, as they belong to previous game */
+	bool bDropMapAreaCellCache;
+
 	/** Number of grid map columns to be rendered by cell actors */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Minesweeper|Grid")
 	uint8 MapAreaMaxHalfSizeX;
@@ -79,6 +133,18 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Minesweeper|Grid")
 	uint8 MapAreaMaxHalfSizeY;
 
+	/** Seconds of pawn movement map area extends ahead by, so cells are streamed in before pawn reaches them */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Minesweeper|Grid", meta = (ClampMin = "0.0"))
+	float MapAreaPrefetchSeconds;
+
+	/** Max number of cells map area extends ahead of pawn by */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Minesweeper|Grid")
+	uint8 MapAreaMaxPrefetchCells;
+
+	/** Number of cells beyond map area its cells are kept within, so pawn moving back and forth does not churn them */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Minesweeper|Grid")
+	uint8 MapAreaEvictionMargin;
+
 	/** Player previously visited cell coords (inside or outside of grid actor) */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Minesweeper|Grid")
 	FIntPoint PrevPlayerRelativeGridCoords;
@@ -90,23 +156,63 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Minesweeper|Grid")
 	int32 GridMapAreaVersion;
 
-	virtual void BeginPlay() override;
+	/** Share of connection net speed map area changes of remote player may use */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Minesweeper|Net", meta = (ClampMin = "0.01", ClampMax = "1.0"))
+	float MapAreaNetSpeedShare;
+
+	/** Estimated number of bytes replicating single map area cell takes, as delta-coded sparse coords and 4-bit value */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Minesweeper|Net", meta = (ClampMin = "1"))
+	int32 MapAreaCellNetBytes;
+
+	/** Game time of latest flush of map area changes, budget of next one growing with time since */
+	float LastMapAreaChangesFlushTime;
 
-	virtual void Tick(float DeltaSeconds) override;
+	/** Map area changes merged until next flush */
+	UPROPERTY()
+	FMineGridMapPendingChanges PendingMapAreaChanges;
+
+	/** Handle of timer flushing pending map area changes once per net update */
+	FTimerHandle FlushMapAreaChangesTimerHandle;
+
+	/** Handle of pawn root component transform binding, cells of map area following pawn movement */
+	FDelegateHandle PawnTransformUpdatedHandle;
+
+	virtual void BeginPlay() override;
 
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+	virtual void OnPossess(APawn* InPawn) override;
+
+	virtual void OnUnPossess() override;
+
+	UFUNCTION()
+	void OnRep_MapAreaBounds(const FMineGridMapAreaBounds& OldMapAreaBounds);
+
+	void ScheduleMapAreaChangesFlush();
+
+	/** Sends out at most given number of pending map area changes, nearest to pawn first */
+	void SendMapAreaChanges(const int32 MaxNumCells);
+
+	/** Number of map area cells next flush may send out within net speed budget of connection */
+	int32 GetMapAreaChangesFlushBudget() const;
+
 	UFUNCTION()
 	void HandleOnTriggeredCoords(const FIntPoint& EnteredCoords);
 
+	void HandleOnPawnTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
 	UFUNCTION(Server, Reliable, BlueprintCallable)
 	void SelectNewGame(const uint8 MapSize);
 
-	UFUNCTION(NetMulticast, Reliable)
-	void ApplyAddedRemovedGridCells(const FMineGridMapChanges& GridMapChanges);
+	/** Starts new game with mines layout reproduced from seed, random one if zero, and share of mined cells */
+	UFUNCTION(Server, Reliable, BlueprintCallable)
+	void SelectNewSeededGame(const uint8 MapSize, const int32 Seed, const float MineDensity);
 
-	UFUNCTION(NetMulticast, Reliable)
-	void ApplyUpdatedGridCellValues(const FMineGridMapCellUpdates& GridMapChanges);
+	/** Number of cells map area extends by ahead of pawn velocity, signed per axis */
+	FIntPoint GetMapAreaPrefetchCells(APawn* PlayerPawn) const;
+
+	/** Largest number of cells of map area, extending ahead by max prefetched cells, along with cells kept within eviction margin */
+	int32 GetMapAreaMaxNumCells() const;
 
 	AMineGridBase* FindMineGridActor();
 	FIntPoint GetPawnRelativeLocationOfGrid(APawn* PlayerPawn, AMineGridBase* MineGrid);
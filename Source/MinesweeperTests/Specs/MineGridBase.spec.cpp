@@ -0,0 +1,442 @@
+#include "Misc/AutomationTest.h"
+#include "AIController.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "GameFramework/Character.h"
+#include "HAL/PlatformTime.h"
+#include "Minesweeper/MineGrid/MineGridBase.h"
+
+namespace MineGridBaseSpec
+{
+	/** Creates world playing as game, for grid actors to be spawned in */
+	UWorld* CreateWorld()
+	{
+		UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		FURL URL;
+		World->InitializeActorsForPlay(URL);
+		World->BeginPlay();
+
+		return World;
+	}
+
+	void DestroyWorld(UWorld* World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	/** Spawns grid drawing cells either by cell actors or instances, begin play seeing the mode already set */
+	AMineGridBase* SpawnMineGrid(UWorld* World, const bool bUseInstancedCells)
+	{
+		AMineGridBase* MineGrid = World->SpawnActorDeferred<AMineGridBase>(AMineGridBase::StaticClass(), FTransform::Identity);
+		FindFieldChecked<FBoolProperty>(AMineGridBase::StaticClass(), TEXT("bUseInstancedCells"))->SetPropertyValue_InContainer(MineGrid, bUseInstancedCells);
+		MineGrid->FinishSpawning(FTransform::Identity);
+
+		return MineGrid;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FMineGridBaseBenchmark, "Minesweeper.Benchmark.MineGridBase", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+	UWorld* World = nullptr;
+	AMineGridBase* MineGrid = nullptr;
+
+	/** Spawns cells of map area of given half size and returns average seconds of triggering one of them */
+	double MeasureTriggerSeconds(const FIntPoint& MapAreaMaxHalfSize)
+	{
+		FMineGridMapChanges GridMapChanges;
+		GridMapChanges.NewGridDimensions = MapAreaMaxHalfSize * 2 + 1;
+
+		for (int32 Y = -MapAreaMaxHalfSize.Y; Y <= MapAreaMaxHalfSize.Y; Y++)
+		{
+			for (int32 X = -MapAreaMaxHalfSize.X; X <= MapAreaMaxHalfSize.X; X++)
+			{
+				GridMapChanges.AddedGridMapCellCoords.Emplace(X, Y);
+				GridMapChanges.AddedGridMapCellValues.Emplace(EMineGridMapCell::MGMC_Undiscovered);
+			}
+		}
+		MineGrid->AddOrRemoveGridCells(GridMapChanges);
+		MineGrid->FlushCellChanges();
+
+		TArray<AMineGridCellBase*> Cells;
+		MineGrid->GetGridCells().ForEach([&Cells](const FIntPoint& Coords, const FMineGridCellSlot& Slot) {
+			Cells.Add(Slot.Cell);
+		});
+
+		// Trigger cells spread over whole area, so that position in map makes no difference
+		constexpr int32 NumTriggers = 20000;
+		const double StartSeconds = FPlatformTime::Seconds();
+		for (int32 TriggerIndex = 0; TriggerIndex < NumTriggers; TriggerIndex++)
+		{
+			MineGrid->HandleCharacterCellTriggering(Cells[(TriggerIndex * 7919) % Cells.Num()], nullptr);
+		}
+		const double TriggerSeconds = (FPlatformTime::Seconds() - StartSeconds) / NumTriggers;
+
+		// Remove spawned cells for next measurement
+		GridMapChanges.RemovedGridMapCells = GridMapChanges.AddedGridMapCellCoords;
+		GridMapChanges.AddedGridMapCellCoords.Reset();
+		GridMapChanges.AddedGridMapCellValues.Reset();
+		MineGrid->AddOrRemoveGridCells(GridMapChanges);
+		MineGrid->FlushCellChanges();
+
+		return TriggerSeconds;
+	}
+END_DEFINE_SPEC(FMineGridBaseBenchmark)
+
+void FMineGridBaseBenchmark::Define()
+{
+	BeforeEach([this]() {
+		// Setup
+		World = MineGridBaseSpec::CreateWorld();
+		MineGrid = World->SpawnActor<AMineGridBase>();
+	});
+
+	Describe("HandleCharacterCellTriggering", [this]() {
+		It("should take the same time regardless of map area size", [this]() {
+			// Act
+			const TArray<FIntPoint> MapAreaMaxHalfSizes = { FIntPoint(2, 1), FIntPoint(8, 5), FIntPoint(32, 20) };
+
+			TArray<double> TriggerSeconds;
+			for (const FIntPoint& MapAreaMaxHalfSize : MapAreaMaxHalfSizes)
+			{
+				TriggerSeconds.Add(MeasureTriggerSeconds(MapAreaMaxHalfSize));
+				AddInfo(FString::Printf(TEXT("MapAreaMaxHalfSize %s: %.3f us per trigger"), *MapAreaMaxHalfSize.ToString(), TriggerSeconds.Last() * 1e6));
+			}
+
+			// Assert, with tolerance of timer noise
+			TestTrue(TEXT("Trigger latency of largest area close to smallest one"), TriggerSeconds.Last() <= TriggerSeconds[0] * 3.0 + 1e-6);
+		});
+	});
+
+	AfterEach([this]() {
+		// Teardown
+		MineGridBaseSpec::DestroyWorld(World);
+	});
+}
+
+BEGIN_DEFINE_SPEC(FMineGridBaseTest, "Minesweeper.MineGridBase", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+	UWorld* World = nullptr;
+	AMineGridBase* MineGrid = nullptr;
+	UInstancedStaticMeshComponent* CellInstances = nullptr;
+	ACharacter* TrackedCharacter = nullptr;
+
+	/** Adds cells of given values and removes given cells, applying changes right away */
+	void AddOrRemoveCells(const TArray<FIntPoint>& AddedCoords, const TArray<EMineGridMapCell>& AddedValues, const TArray<FIntPoint>& RemovedCoords)
+	{
+		FMineGridMapChanges GridMapChanges;
+		GridMapChanges.NewGridDimensions = FIntPoint(64, 64);
+		GridMapChanges.AddedGridMapCellCoords = AddedCoords;
+		GridMapChanges.AddedGridMapCellValues = AddedValues;
+		GridMapChanges.RemovedGridMapCells = RemovedCoords;
+
+		MineGrid->AddOrRemoveGridCells(GridMapChanges);
+		MineGrid->FlushCellChanges();
+	}
+
+	/** Whether cell at given coords is shown by cell actor */
+	bool IsCellShownAt(const FIntPoint& CellCoords) const
+	{
+		const FMineGridCellSlot* CellSlot = MineGrid->GetGridCells().Find(CellCoords);
+		return CellSlot && CellSlot->Cell;
+	}
+
+	/** Location of middle of cell at given coords in world */
+	FVector GetCellCenter(const FIntPoint& CellCoords) const
+	{
+		return FVector(CellCoords.X + 0.5f, CellCoords.Y + 0.5f, 0.f) * MineGrid->GetCellSize();
+	}
+
+	/** Custom data value of shown instance at location of given cell, or negative value if no instance shows it */
+	float GetInstanceValueAt(const FIntPoint& CellCoords) const
+	{
+		const FVector CellLocation = FVector(CellCoords.X, CellCoords.Y, 0.f) * MineGrid->GetCellSize();
+		for (int32 InstanceIndex = 0; InstanceIndex < CellInstances->GetInstanceCount(); InstanceIndex++)
+		{
+			FTransform InstanceTransform;
+			CellInstances->GetInstanceTransform(InstanceIndex, InstanceTransform);
+
+			if (!InstanceTransform.GetScale3D().IsNearlyZero() && InstanceTransform.GetLocation().Equals(CellLocation))
+			{
+				return CellInstances->PerInstanceSMCustomData[InstanceIndex * CellInstances->NumCustomDataFloats];
+			}
+		}
+		return -1.f;
+	}
+
+	/** Moves map area of given half size by one column, the way walking pawn does */
+	void MoveMapArea(const FIntPoint& Center, const FIntPoint& MapAreaMaxHalfSize, const int32 StepX)
+	{
+		FMineGridMapChanges GridMapChanges;
+		GridMapChanges.NewGridDimensions = FIntPoint(64, 64);
+
+		const int32 RemovedX = Center.X - StepX * MapAreaMaxHalfSize.X;
+		const int32 AddedX = Center.X + StepX * (MapAreaMaxHalfSize.X + 1);
+		for (int32 Y = Center.Y - MapAreaMaxHalfSize.Y; Y <= Center.Y + MapAreaMaxHalfSize.Y; Y++)
+		{
+			GridMapChanges.RemovedGridMapCells.Emplace(RemovedX, Y);
+			GridMapChanges.AddedGridMapCellCoords.Emplace(AddedX, Y);
+			GridMapChanges.AddedGridMapCellValues.Emplace(EMineGridMapCell::MGMC_Undiscovered);
+		}
+		MineGrid->AddOrRemoveGridCells(GridMapChanges);
+		MineGrid->FlushCellChanges();
+	}
+END_DEFINE_SPEC(FMineGridBaseTest)
+
+void FMineGridBaseTest::Define()
+{
+	BeforeEach([this]() {
+		// Setup
+		World = MineGridBaseSpec::CreateWorld();
+	});
+
+	Describe("AddOrRemoveGridCells", [this]() {
+		BeforeEach([this]() {
+			// Setup
+			MineGrid = MineGridBaseSpec::SpawnMineGrid(World, false);
+		});
+
+		It("should show queued cells only once applied", [this]() {
+			// Prepare
+			FMineGridMapChanges GridMapChanges;
+			GridMapChanges.NewGridDimensions = FIntPoint(64, 64);
+			for (int32 X = 0; X < 10; X++)
+			{
+				GridMapChanges.AddedGridMapCellCoords.Emplace(X, 0);
+				GridMapChanges.AddedGridMapCellValues.Emplace(EMineGridMapCell::MGMC_Undiscovered);
+			}
+
+			// Act
+			MineGrid->AddOrRemoveGridCells(GridMapChanges);
+			const int32 NumShownCellsBeforeFlush = MineGrid->GetCellPoolStats().HighWaterMark;
+
+			MineGrid->FlushCellChanges();
+			const int32 NumShownCellsAfterFlush = MineGrid->GetCellPoolStats().HighWaterMark;
+
+			// Assert, no possessed pawn being there for any cell to be applied right away
+			TestEqual(TEXT("NumShownCellsBeforeFlush"), NumShownCellsBeforeFlush, 0);
+			TestEqual(TEXT("NumShownCellsAfterFlush"), NumShownCellsAfterFlush, 10);
+		});
+
+		It("should spawn no cell actors while walking around", [this]() {
+			// Prepare
+			const FIntPoint MapAreaMaxHalfSize(8, 5);
+			FIntPoint Center(16, 16);
+
+			TArray<FIntPoint> AddedCoords;
+			TArray<EMineGridMapCell> AddedValues;
+			for (int32 Y = Center.Y - MapAreaMaxHalfSize.Y; Y <= Center.Y + MapAreaMaxHalfSize.Y; Y++)
+			{
+				for (int32 X = Center.X - MapAreaMaxHalfSize.X; X <= Center.X + MapAreaMaxHalfSize.X; X++)
+				{
+					AddedCoords.Emplace(X, Y);
+					AddedValues.Emplace(EMineGridMapCell::MGMC_Undiscovered);
+				}
+			}
+			AddOrRemoveCells(AddedCoords, AddedValues, {});
+
+			// Act
+			for (int32 StepIndex = 0; StepIndex < 20; StepIndex++)
+			{
+				const int32 StepX = StepIndex < 10 ? 1 : -1;
+				MoveMapArea(Center, MapAreaMaxHalfSize, StepX);
+				Center.X += StepX;
+			}
+
+			// Assert
+			const FMineGridCellPoolStats CellPoolStats = MineGrid->GetCellPoolStats();
+			TestEqual(TEXT("CellPoolStats.NumMisses"), CellPoolStats.NumMisses, 0);
+			TestEqual(TEXT("CellPoolStats.NumHits"), CellPoolStats.NumHits, 17 * 11 + 20 * 11);
+			TestEqual(TEXT("CellPoolStats.HighWaterMark"), CellPoolStats.HighWaterMark, 17 * 11);
+		});
+	});
+
+	Describe("ReserveCellPool", [this]() {
+		BeforeEach([this]() {
+			// Setup
+			MineGrid = MineGridBaseSpec::SpawnMineGrid(World, false);
+		});
+
+		It("should pre-warm pool for largest default map area, prefetched and evicted cells included", [this]() {
+			// Prepare
+			TArray<FIntPoint> AddedCoords;
+			TArray<EMineGridMapCell> AddedValues;
+			for (int32 Y = 0; Y < 19; Y++)
+			{
+				for (int32 X = 0; X < 25; X++)
+				{
+					AddedCoords.Emplace(X, Y);
+					AddedValues.Emplace(EMineGridMapCell::MGMC_Undiscovered);
+				}
+			}
+
+			// Act
+			AddOrRemoveCells(AddedCoords, AddedValues, {});
+
+			// Assert
+			TestEqual(TEXT("CellPoolStats.NumMisses"), MineGrid->GetCellPoolStats().NumMisses, 0);
+		});
+
+		It("should grow pool until it and shown cells hold given number of cells", [this]() {
+			// Prepare
+			AddOrRemoveCells({ FIntPoint(0, 40), FIntPoint(1, 40) }, { EMineGridMapCell::MGMC_One, EMineGridMapCell::MGMC_Two }, {});
+
+			TArray<FIntPoint> AddedCoords;
+			TArray<EMineGridMapCell> AddedValues;
+			for (int32 Y = 0; Y < 25; Y++)
+			{
+				for (int32 X = 0; X < 24; X++)
+				{
+					AddedCoords.Emplace(X, Y);
+					AddedValues.Emplace(EMineGridMapCell::MGMC_Undiscovered);
+				}
+			}
+
+			// Act
+			MineGrid->ReserveCellPool(602);
+
+			// Assert
+			AddOrRemoveCells(AddedCoords, AddedValues, {});
+			TestEqual(TEXT("CellPoolStats.NumMisses after reserved cells"), MineGrid->GetCellPoolStats().NumMisses, 0);
+
+			AddOrRemoveCells({ FIntPoint(0, 30) }, { EMineGridMapCell::MGMC_Undiscovered }, {});
+			TestEqual(TEXT("CellPoolStats.NumMisses after one more cell"), MineGrid->GetCellPoolStats().NumMisses, 1);
+		});
+	});
+
+	Describe("ApplyPendingCellChanges", [this]() {
+		BeforeEach([this]() {
+			// Setup, applying single queued change per tick
+			MineGrid = MineGridBaseSpec::SpawnMineGrid(World, false);
+			FindFieldChecked<FBoolProperty>(AMineGridBase::StaticClass(), TEXT("bUseGridTriggering"))->SetPropertyValue_InContainer(MineGrid, true);
+			FindFieldChecked<FFloatProperty>(AMineGridBase::StaticClass(), TEXT("CellChangesFrameBudgetMs"))->SetPropertyValue_InContainer(MineGrid, 1e-6f);
+
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			TrackedCharacter = World->SpawnActor<ACharacter>(GetCellCenter(FIntPoint(10, 0)), FRotator::ZeroRotator, SpawnParameters);
+			MineGrid->BeginTrackingCharacter(TrackedCharacter);
+
+			FMineGridMapChanges GridMapChanges;
+			GridMapChanges.NewGridDimensions = FIntPoint(64, 64);
+			for (int32 X = 0; X <= 20; X++)
+			{
+				GridMapChanges.AddedGridMapCellCoords.Emplace(X, 0);
+				GridMapChanges.AddedGridMapCellValues.Emplace(EMineGridMapCell::MGMC_Undiscovered);
+			}
+			MineGrid->AddOrRemoveGridCells(GridMapChanges);
+		});
+
+		It("should apply cells around tracked character right away and nearest queued ones first", [this]() {
+			// Act & Assert
+			TestTrue(TEXT("IsCellShownAt(9, 0) before tick"), IsCellShownAt(FIntPoint(9, 0)));
+			TestTrue(TEXT("IsCellShownAt(11, 0) before tick"), IsCellShownAt(FIntPoint(11, 0)));
+			TestEqual(TEXT("HighWaterMark before tick"), MineGrid->GetCellPoolStats().HighWaterMark, 3);
+
+			World->Tick(LEVELTICK_All, 0.01f);
+			TestEqual(TEXT("HighWaterMark after tick"), MineGrid->GetCellPoolStats().HighWaterMark, 4);
+			TestTrue(TEXT("IsCellShownAt(8, 0) || IsCellShownAt(12, 0)"), IsCellShownAt(FIntPoint(8, 0)) || IsCellShownAt(FIntPoint(12, 0)));
+		});
+
+		It("should apply cells around pawn of player not playing locally right away, as server cells trigger under it", [this]() {
+			// Prepare, pawn not tracked by grid being possessed by controller of no local player
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			APawn* RemotePawn = World->SpawnActor<ACharacter>(GetCellCenter(FIntPoint(30, 0)), FRotator::ZeroRotator, SpawnParameters);
+			AController* RemoteController = World->SpawnActor<AAIController>(SpawnParameters);
+			RemoteController->Possess(RemotePawn);
+
+			FMineGridMapChanges GridMapChanges;
+			GridMapChanges.NewGridDimensions = FIntPoint(64, 64);
+			for (int32 X = 29; X <= 31; X++)
+			{
+				GridMapChanges.AddedGridMapCellCoords.Emplace(X, 0);
+				GridMapChanges.AddedGridMapCellValues.Emplace(EMineGridMapCell::MGMC_Undiscovered);
+			}
+
+			// Act
+			MineGrid->AddOrRemoveGridCells(GridMapChanges);
+
+			// Assert
+			TestFalse(TEXT("RemoteController->IsLocalPlayerController()"), RemoteController->IsLocalPlayerController());
+			TestTrue(TEXT("IsCellShownAt(29, 0)"), IsCellShownAt(FIntPoint(29, 0)));
+			TestTrue(TEXT("IsCellShownAt(30, 0)"), IsCellShownAt(FIntPoint(30, 0)));
+			TestTrue(TEXT("IsCellShownAt(31, 0)"), IsCellShownAt(FIntPoint(31, 0)));
+		});
+
+		It("should apply queued cells nearest to new focus first once tracked character moves", [this]() {
+			// Act
+			TrackedCharacter->SetActorLocation(GetCellCenter(FIntPoint(0, 0)));
+			World->Tick(LEVELTICK_All, 0.01f);
+
+			// Assert
+			TestTrue(TEXT("IsCellShownAt(0, 0)"), IsCellShownAt(FIntPoint(0, 0)));
+			TestFalse(TEXT("IsCellShownAt(20, 0)"), IsCellShownAt(FIntPoint(20, 0)));
+		});
+	});
+
+	Describe("Instanced cells", [this]() {
+		BeforeEach([this]() {
+			// Setup
+			MineGrid = MineGridBaseSpec::SpawnMineGrid(World, true);
+			CellInstances = MineGrid->FindComponentByClass<UInstancedStaticMeshComponent>();
+		});
+
+		It("should be drawn by movable component, as instances change with every step", [this]() {
+			// Assert
+			TestTrue(TEXT("UsesInstancedCells()"), MineGrid->UsesInstancedCells());
+			TestTrue(TEXT("Mobility == Movable"), CellInstances->Mobility == EComponentMobility::Movable);
+		});
+
+		It("should show every added cell by instance at its location with its value as custom data", [this]() {
+			// Act
+			AddOrRemoveCells(
+				{ FIntPoint(0, 0), FIntPoint(1, 0), FIntPoint(0, 1) },
+				{ EMineGridMapCell::MGMC_Undiscovered, EMineGridMapCell::MGMC_Two, EMineGridMapCell::MGMC_Zero },
+				{}
+			);
+
+			// Assert
+			TestEqual(TEXT("GetInstanceCount()"), CellInstances->GetInstanceCount(), 3);
+			TestEqual(TEXT("Value at (0, 0)"), GetInstanceValueAt(FIntPoint(0, 0)), (float)EMineGridMapCell::MGMC_Undiscovered);
+			TestEqual(TEXT("Value at (1, 0)"), GetInstanceValueAt(FIntPoint(1, 0)), (float)EMineGridMapCell::MGMC_Two);
+			TestEqual(TEXT("Value at (0, 1)"), GetInstanceValueAt(FIntPoint(0, 1)), (float)EMineGridMapCell::MGMC_Zero);
+		});
+
+		It("should pass updated cell value to custom data of its instance", [this]() {
+			// Prepare
+			AddOrRemoveCells({ FIntPoint(2, 3) }, { EMineGridMapCell::MGMC_Undiscovered }, {});
+
+			FMineGridMapCellUpdates CellUpdates;
+			CellUpdates.UpdatedGridMapCellCoords.Add(FIntPoint(2, 3));
+			CellUpdates.UpdatedGridMapCellValues.Add(EMineGridMapCell::MGMC_Exploded);
+
+			// Act
+			MineGrid->UpdateCellValues(CellUpdates);
+			MineGrid->FlushCellChanges();
+
+			// Assert
+			TestEqual(TEXT("GetInstanceCount()"), CellInstances->GetInstanceCount(), 1);
+			TestEqual(TEXT("Value at (2, 3)"), GetInstanceValueAt(FIntPoint(2, 3)), (float)EMineGridMapCell::MGMC_Exploded);
+		});
+
+		It("should hide instance of removed cell and reuse it for added one", [this]() {
+			// Prepare
+			AddOrRemoveCells({ FIntPoint(0, 0), FIntPoint(1, 0) }, { EMineGridMapCell::MGMC_One, EMineGridMapCell::MGMC_Three }, {});
+
+			// Act & Assert
+			AddOrRemoveCells({}, {}, { FIntPoint(1, 0) });
+			TestEqual(TEXT("GetInstanceCount() after removal"), CellInstances->GetInstanceCount(), 2);
+			TestTrue(TEXT("Value at (1, 0) after removal < 0"), GetInstanceValueAt(FIntPoint(1, 0)) < 0.f);
+
+			AddOrRemoveCells({ FIntPoint(5, 5) }, { EMineGridMapCell::MGMC_Revealed }, {});
+			TestEqual(TEXT("GetInstanceCount() after addition"), CellInstances->GetInstanceCount(), 2);
+			TestEqual(TEXT("Value at (0, 0)"), GetInstanceValueAt(FIntPoint(0, 0)), (float)EMineGridMapCell::MGMC_One);
+			TestEqual(TEXT("Value at (5, 5)"), GetInstanceValueAt(FIntPoint(5, 5)), (float)EMineGridMapCell::MGMC_Revealed);
+		});
+	});
+
+	AfterEach([this]() {
+		// Teardown
+		MineGridBaseSpec::DestroyWorld(World);
+	});
+}
@@ -0,0 +1,168 @@
+#include "Misc/AutomationTest.h"
+#include "Minesweeper/Includes/MineGridMap.h"
+
+BEGIN_DEFINE_SPEC(FMineGridMapTest, "Minesweeper.MineGridMap", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+	FMineGridMap MineGridMap;
+END_DEFINE_SPEC(FMineGridMapTest)
+
+void FMineGridMapTest::Define()
+{
+	Describe("InitChunked", [this]() {
+		BeforeEach([this]() {
+			// Setup, with partial tiles along right and bottom edges
+			MineGridMap.InitChunked(FIntPoint(FMineGridMap::TileSize * 2 + 10, FMineGridMap::TileSize + 20));
+		});
+
+		It("should allocate no tile until cell gets discovered", [this]() {
+			// Act
+			MineGridMap.SetCell(FIntPoint(3, 4), EMineGridMapCell::MGMC_Undiscovered);
+
+			// Assert
+			TestEqual(TEXT("TileSlots.Num()"), MineGridMap.TileSlots.Num(), 0);
+			TestEqual(TEXT("TileCells.Num()"), MineGridMap.TileCells.Num(), 0);
+			TestEqual(TEXT("GetCell(3, 4)"), MineGridMap.GetCell(FIntPoint(3, 4)), EMineGridMapCell::MGMC_Undiscovered);
+			TestEqual(TEXT("GetTileSummary(0, 0)"), MineGridMap.GetTileSummary(FIntPoint(0, 0)), EMineGridMapTileSummary::MGMTS_AllUndiscovered);
+		});
+
+		It("should allocate only tile of discovered cell", [this]() {
+			// Prepare
+			const FIntPoint GivenCoords(FMineGridMap::TileSize + 5, FMineGridMap::TileSize + 6);
+
+			// Act
+			MineGridMap.SetCell(GivenCoords, EMineGridMapCell::MGMC_Three);
+
+			// Assert
+			TestEqual(TEXT("TileSlots.Num()"), MineGridMap.TileSlots.Num(), 1);
+			TestTrue(TEXT("TileSlots.Contains(1, 1)"), MineGridMap.TileSlots.Contains(FIntPoint(1, 1)));
+			TestEqual(TEXT("TileCells.Num()"), MineGridMap.TileCells.Num(), FMineGridMap::TileNumBytes);
+
+			TestEqual(TEXT("GetCell(GivenCoords)"), MineGridMap.GetCell(GivenCoords), EMineGridMapCell::MGMC_Three);
+			TestEqual(TEXT("GetCell(GivenCoords + (1, 0))"), MineGridMap.GetCell(GivenCoords + FIntPoint(1, 0)), EMineGridMapCell::MGMC_Undiscovered);
+			TestEqual(TEXT("GetCell(5, 6)"), MineGridMap.GetCell(FIntPoint(5, 6)), EMineGridMapCell::MGMC_Undiscovered);
+		});
+
+		It("should summarize tile as mixed until every cell of it gets discovered", [this]() {
+			// Prepare
+			const FIntPoint GivenTileCoords(0, 0);
+
+			// Act & Assert
+			MineGridMap.SetCell(FIntPoint(0, 0), EMineGridMapCell::MGMC_Revealed);
+			TestEqual(TEXT("GetTileSummary after first cell"), MineGridMap.GetTileSummary(GivenTileCoords), EMineGridMapTileSummary::MGMTS_Mixed);
+
+			for (int32 Y = 0; Y < FMineGridMap::TileSize; Y++) {
+				for (int32 X = 0; X < FMineGridMap::TileSize; X++) {
+					MineGridMap.SetCell(FIntPoint(X, Y), EMineGridMapCell::MGMC_Zero);
+				}
+			}
+			TestEqual(TEXT("GetTileSummary after every cell"), MineGridMap.GetTileSummary(GivenTileCoords), EMineGridMapTileSummary::MGMTS_AllDiscovered);
+
+			MineGridMap.SetCell(FIntPoint(7, 7), EMineGridMapCell::MGMC_Undiscovered);
+			TestEqual(TEXT("GetTileSummary after undiscovering cell"), MineGridMap.GetTileSummary(GivenTileCoords), EMineGridMapTileSummary::MGMTS_Mixed);
+			TestEqual(TEXT("TileNumDiscovered[0]"), MineGridMap.TileNumDiscovered[0], FMineGridMap::TileSize * FMineGridMap::TileSize - 1);
+		});
+
+		It("should summarize partial tile by its cells inside of map only", [this]() {
+			// Prepare
+			const FIntPoint GivenTileCoords(2, 1);
+			const FIntPoint TileStartCoords = GivenTileCoords * FMineGridMap::TileSize;
+
+			// Act
+			for (int32 Y = TileStartCoords.Y; Y <= MineGridMap.EndCoords.Y; Y++) {
+				for (int32 X = TileStartCoords.X; X <= MineGridMap.EndCoords.X; X++) {
+					MineGridMap.SetCell(FIntPoint(X, Y), EMineGridMapCell::MGMC_One);
+				}
+			}
+
+			// Assert
+			TestEqual(TEXT("GetTileNumCells"), MineGridMap.GetTileNumCells(GivenTileCoords), 10 * 20);
+			TestEqual(TEXT("GetTileSummary"), MineGridMap.GetTileSummary(GivenTileCoords), EMineGridMapTileSummary::MGMTS_AllDiscovered);
+			TestEqual(TEXT("GetTileSummary of other tile"), MineGridMap.GetTileSummary(FIntPoint(1, 1)), EMineGridMapTileSummary::MGMTS_AllUndiscovered);
+		});
+
+		It("should drop tiles when initialized again", [this]() {
+			// Prepare
+			MineGridMap.SetCell(FIntPoint(0, 0), EMineGridMapCell::MGMC_Revealed);
+
+			// Act
+			MineGridMap.InitChunked(FIntPoint(10, 10));
+
+			// Assert
+			TestEqual(TEXT("TileSlots.Num()"), MineGridMap.TileSlots.Num(), 0);
+			TestEqual(TEXT("GetCell(0, 0)"), MineGridMap.GetCell(FIntPoint(0, 0)), EMineGridMapCell::MGMC_Undiscovered);
+			TestEqual(TEXT("GetTileSummary(0, 0)"), MineGridMap.GetTileSummary(FIntPoint(0, 0)), EMineGridMapTileSummary::MGMTS_AllUndiscovered);
+		});
+	});
+
+	Describe("InitWindow", [this]() {
+		BeforeEach([this]() {
+			// Setup
+			MineGridMap.InitWindow(FIntPoint(5, 3));
+		});
+
+		It("should hold no cells until they are set", [this]() {
+			// Prepare
+			MineGridMap.StartCoords = FIntPoint(-2, -1);
+			MineGridMap.EndCoords = FIntPoint(2, 1);
+
+			// Act
+			MineGridMap.SetCell(FIntPoint(-2, -1), EMineGridMapCell::MGMC_Two);
+
+			// Assert
+			TestEqual(TEXT("WindowCells.Dimensions"), MineGridMap.WindowCells.Dimensions, FIntPoint(8, 4));
+			TestTrue(TEXT("HasCell(-2, -1)"), MineGridMap.HasCell(FIntPoint(-2, -1)));
+			TestEqual(TEXT("GetCell(-2, -1)"), MineGridMap.GetCell(FIntPoint(-2, -1)), EMineGridMapCell::MGMC_Two);
+			TestFalse(TEXT("HasCell(-1, -1)"), MineGridMap.HasCell(FIntPoint(-1, -1)));
+
+			// Cell aliasing held one is outside of bounds
+			TestFalse(TEXT("HasCell(6, -1)"), MineGridMap.HasCell(FIntPoint(6, -1)));
+		});
+
+		It("should reuse cells of wrapped columns as bounds move", [this]() {
+			// Prepare
+			MineGridMap.StartCoords = FIntPoint(0, 0);
+			MineGridMap.EndCoords = FIntPoint(4, 2);
+			for (int32 Y = 0; Y <= 2; Y++) {
+				for (int32 X = 0; X <= 4; X++) {
+					MineGridMap.SetCell(FIntPoint(X, Y), EMineGridMapCell::MGMC_One);
+				}
+			}
+
+			// Act
+			MineGridMap.StartCoords = FIntPoint(6, 0);
+			MineGridMap.EndCoords = FIntPoint(10, 2);
+			for (int32 Y = 0; Y <= 2; Y++) {
+				for (int32 X = 0; X <= 5; X++) {
+					MineGridMap.RemoveCell(FIntPoint(X, Y));
+				}
+				for (int32 X = 6; X <= 10; X++) {
+					MineGridMap.SetCell(FIntPoint(X, Y), EMineGridMapCell::MGMC_Three);
+				}
+			}
+
+			// Assert
+			TMap<FIntPoint, EMineGridMapCell> ExportedCells;
+			MineGridMap.ExportCells(ExportedCells);
+			TestEqual(TEXT("ExportedCells.Num()"), ExportedCells.Num(), 5 * 3);
+			TestEqual(TEXT("GetCell(8, 1)"), MineGridMap.GetCell(FIntPoint(8, 1)), EMineGridMapCell::MGMC_Three);
+			TestEqual(TEXT("WindowCells.Slots.Num()"), MineGridMap.WindowCells.Slots.Num(), 8 * 4);
+			TestEqual(TEXT("WindowCells.OverflowValues.Num()"), MineGridMap.WindowCells.OverflowValues.Num(), 0);
+		});
+
+		It("should keep cells inside of bounds when grown", [this]() {
+			// Prepare
+			MineGridMap.StartCoords = FIntPoint(-3, 5);
+			MineGridMap.EndCoords = FIntPoint(1, 7);
+			MineGridMap.SetCell(FIntPoint(-3, 5), EMineGridMapCell::MGMC_Revealed);
+			MineGridMap.SetCell(FIntPoint(1, 7), EMineGridMapCell::MGMC_Zero);
+
+			// Act
+			MineGridMap.ReserveWindow(FIntPoint(9, 3));
+
+			// Assert
+			TestEqual(TEXT("WindowCells.Dimensions"), MineGridMap.WindowCells.Dimensions, FIntPoint(16, 4));
+			TestEqual(TEXT("GetCell(-3, 5)"), MineGridMap.GetCell(FIntPoint(-3, 5)), EMineGridMapCell::MGMC_Revealed);
+			TestEqual(TEXT("GetCell(1, 7)"), MineGridMap.GetCell(FIntPoint(1, 7)), EMineGridMapCell::MGMC_Zero);
+			TestFalse(TEXT("HasCell(0, 5)"), MineGridMap.HasCell(FIntPoint(0, 5)));
+		});
+	});
+}
@@ -0,0 +1,274 @@
+#include "Misc/AutomationTest.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "Minesweeper/Includes/MineGridMapAreaCells.h"
+
+BEGIN_DEFINE_SPEC(FMineGridMapAreaCellsTest, "Minesweeper.MineGridMapAreaCells", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+	FMineGridMapAreaCells AreaCells;
+	FMineGridMapAreaCells ClientCells;
+
+	/** State client acknowledged latest delta with */
+	TSharedPtr<INetDeltaBaseState> AckedState;
+
+	int32 NumDeltaBytes = 0;
+
+	/** Sends delta of cells against acknowledged state to client cells, returning whether there was any */
+	bool ReplicateDelta()
+	{
+		FBitWriter Writer(0, true);
+		TSharedPtr<INetDeltaBaseState> NewState;
+
+		FNetDeltaSerializeInfo WriteParms;
+		WriteParms.Writer = &Writer;
+		WriteParms.OldState = AckedState.Get();
+		WriteParms.NewState = &NewState;
+
+		const bool bHasDelta = AreaCells.NetDeltaSerialize(WriteParms);
+		AckedState = NewState;
+		NumDeltaBytes = (int32)Writer.GetNumBytes();
+
+		if (bHasDelta)
+		{
+			FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+
+			FNetDeltaSerializeInfo ReadParms;
+			ReadParms.Reader = &Reader;
+
+			TestTrue(TEXT("NetDeltaSerialize of reader"), ClientCells.NetDeltaSerialize(ReadParms));
+		}
+		return bHasDelta;
+	}
+
+	/** Whether client holds the same cells as server */
+	void TestClientCells()
+	{
+		TestEqual(TEXT("ClientCells.Items.Num()"), ClientCells.Items.Num(), AreaCells.Items.Num());
+		TestEqual(TEXT("ClientCells.ReplicatedCells.Num()"), ClientCells.ReplicatedCells.Num(), AreaCells.Items.Num());
+
+		AreaCells.ForEachCell([this](const FIntPoint& Coords, const EMineGridMapCell Value)
+		{
+			const EMineGridMapCell* ReplicatedValue = ClientCells.ReplicatedCells.Find(Coords);
+			TestTrue(FString::Printf(TEXT("ReplicatedCells has %s"), *Coords.ToString()), ReplicatedValue && *ReplicatedValue == Value);
+		});
+	}
+END_DEFINE_SPEC(FMineGridMapAreaCellsTest)
+
+void FMineGridMapAreaCellsTest::Define()
+{
+	Describe("RemoveCell", [this]() {
+		BeforeEach([this]() {
+			AreaCells = FMineGridMapAreaCells();
+			AreaCells.AddCell(FIntPoint(0, 0), EMineGridMapCell::MGMC_Zero);
+			AreaCells.AddCell(FIntPoint(1, 0), EMineGridMapCell::MGMC_One);
+			AreaCells.AddCell(FIntPoint(2, 0), EMineGridMapCell::MGMC_Two);
+		});
+
+		It("should keep item indices of remaining cells", [this]() {
+			// Act
+			AreaCells.RemoveCell(FIntPoint(0, 0));
+			AreaCells.UpdateCell(FIntPoint(2, 0), EMineGridMapCell::MGMC_Undiscovered);
+
+			// Assert
+			TestEqual(TEXT("Items.Num()"), AreaCells.Items.Num(), 2);
+			TestFalse(TEXT("ItemIndices.Contains(0, 0)"), AreaCells.ItemIndices.Contains(FIntPoint(0, 0)));
+
+			AreaCells.ItemIndices.ForEach([this](const FIntPoint& Coords, const int32 ItemIndex)
+			{
+				TestEqual(TEXT("Items[ItemIndex].Coords"), AreaCells.Items[ItemIndex].Coords, Coords);
+			});
+
+			TestEqual(TEXT("Value of (2, 0)"), AreaCells.Items[AreaCells.ItemIndices.FindChecked(FIntPoint(2, 0))].Value, EMineGridMapCell::MGMC_Undiscovered);
+		});
+
+		It("should ignore cells outside of area", [this]() {
+			// Act
+			AreaCells.RemoveCell(FIntPoint(5, 5));
+
+			// Assert
+			TestEqual(TEXT("Items.Num()"), AreaCells.Items.Num(), 3);
+		});
+	});
+	Describe("EvictCell", [this]() {
+		BeforeEach([this]() {
+			AreaCells = FMineGridMapAreaCells();
+			for (int32 X = 0; X < 4; X++)
+			{
+				AreaCells.AddCell(FIntPoint(X, 0), EMineGridMapCell::MGMC_Zero);
+			}
+		});
+
+		It("should remove least recently evicted cells above max number of them", [this]() {
+			// Act
+			AreaCells.EvictCell(FIntPoint(0, 0), 2);
+			AreaCells.EvictCell(FIntPoint(1, 0), 2);
+			AreaCells.AddCell(FIntPoint(0, 0), EMineGridMapCell::MGMC_Zero);
+			AreaCells.EvictCell(FIntPoint(2, 0), 2);
+			AreaCells.EvictCell(FIntPoint(0, 0), 2);
+
+			// Assert
+			TestFalse(TEXT("HasCell(1, 0)"), AreaCells.HasCell(FIntPoint(1, 0)));
+			TestTrue(TEXT("HasCell(0, 0)"), AreaCells.HasCell(FIntPoint(0, 0)));
+			TestTrue(TEXT("HasCell(2, 0)"), AreaCells.HasCell(FIntPoint(2, 0)));
+			TestTrue(TEXT("HasCell(3, 0)"), AreaCells.HasCell(FIntPoint(3, 0)));
+			TestEqual(TEXT("Items.Num()"), AreaCells.Items.Num(), 3);
+		});
+
+		It("should keep value of cell brought back unchanged if it is the same", [this]() {
+			// Prepare
+			AreaCells.EvictCell(FIntPoint(0, 0), 2);
+			const int32 ReplicationKey = AreaCells.Items[AreaCells.ItemIndices.FindChecked(FIntPoint(0, 0))].ReplicationKey;
+
+			// Act
+			AreaCells.AddCell(FIntPoint(0, 0), EMineGridMapCell::MGMC_Zero);
+
+			// Assert
+			TestEqual(TEXT("ReplicationKey"), AreaCells.Items[AreaCells.ItemIndices.FindChecked(FIntPoint(0, 0))].ReplicationKey, ReplicationKey);
+			TestEqual(TEXT("NumEvictedCells"), AreaCells.NumEvictedCells, 0);
+		});
+
+		It("should drop cached cell whose window slot cell entering area takes", [this]() {
+			// Prepare
+			AreaCells.ItemIndices.Reserve(FIntPoint(4, 1));
+			AreaCells.EvictCell(FIntPoint(0, 0), 8);
+
+			// Act, (4, 0) aliasing cached (0, 0) and (5, 0) aliasing (1, 0) still in area
+			AreaCells.AddCell(FIntPoint(4, 0), EMineGridMapCell::MGMC_Zero);
+			AreaCells.AddCell(FIntPoint(5, 0), EMineGridMapCell::MGMC_Zero);
+
+			// Assert
+			TestFalse(TEXT("HasCell(0, 0)"), AreaCells.HasCell(FIntPoint(0, 0)));
+			TestTrue(TEXT("HasCell(1, 0)"), AreaCells.HasCell(FIntPoint(1, 0)));
+			TestTrue(TEXT("HasCell(4, 0)"), AreaCells.HasCell(FIntPoint(4, 0)));
+			TestTrue(TEXT("HasCell(5, 0)"), AreaCells.HasCell(FIntPoint(5, 0)));
+			TestEqual(TEXT("NumEvictedCells"), AreaCells.NumEvictedCells, 0);
+			TestEqual(TEXT("Items.Num()"), AreaCells.Items.Num(), 5);
+			TestEqual(TEXT("ItemIndices.OverflowValues.Num()"), AreaCells.ItemIndices.OverflowValues.Num(), 1);
+		});
+	});
+	Describe("NetDeltaSerialize", [this]() {
+		BeforeEach([this]() {
+			AreaCells = FMineGridMapAreaCells();
+			ClientCells = FMineGridMapAreaCells();
+			AckedState.Reset();
+		});
+
+		It("should restore cells of rects and sparse cells, taking fewer bytes", [this]() {
+			// Prepare
+			int32 NumGivenCells = 0;
+			for (int32 Y = 5; Y < 9; Y++)
+			{
+				for (int32 X = -2; X < 30; X++)
+				{
+					AreaCells.AddCell(FIntPoint(X, Y), (EMineGridMapCell)(NumGivenCells++ % (int32)EMineGridMapCell::MGMC_MAX));
+				}
+				AreaCells.AddCell(FIntPoint(100 - Y * 7, Y * 3), (EMineGridMapCell)(NumGivenCells++ % (int32)EMineGridMapCell::MGMC_MAX));
+			}
+
+			// Act
+			const bool bHasDelta = ReplicateDelta();
+
+			// Assert
+			TestTrue(TEXT("bHasDelta"), bHasDelta);
+			TestClientCells();
+			TestTrue(TEXT("NumDeltaBytes < 1/4 of unpacked size"), NumDeltaBytes * 4 < NumGivenCells * 9);
+		});
+
+		It("should send cells removed and changed since acknowledged state", [this]() {
+			// Prepare
+			for (int32 X = 0; X < 8; X++)
+			{
+				AreaCells.AddCell(FIntPoint(X, 0), EMineGridMapCell::MGMC_Undiscovered);
+			}
+			ReplicateDelta();
+
+			// Act
+			AreaCells.RemoveCell(FIntPoint(0, 0));
+			AreaCells.RemoveCell(FIntPoint(5, 0));
+			AreaCells.UpdateCell(FIntPoint(3, 0), EMineGridMapCell::MGMC_Three);
+			AreaCells.AddCell(FIntPoint(8, 0), EMineGridMapCell::MGMC_One);
+			const bool bHasDelta = ReplicateDelta();
+
+			// Assert
+			TestTrue(TEXT("bHasDelta"), bHasDelta);
+			TestClientCells();
+			TestFalse(TEXT("ClientCells.HasCell(0, 0)"), ClientCells.HasCell(FIntPoint(0, 0)));
+			TestFalse(TEXT("ClientCells.HasCell(5, 0)"), ClientCells.HasCell(FIntPoint(5, 0)));
+
+			ClientCells.ItemIndices.ForEach([this](const FIntPoint& Coords, const int32 ItemIndex)
+			{
+				TestEqual(TEXT("ClientCells.Items[ItemIndex].Coords"), ClientCells.Items[ItemIndex].Coords, Coords);
+			});
+		});
+
+		It("should send nothing while no cell changes", [this]() {
+			// Prepare
+			AreaCells.AddCell(FIntPoint(0, 0), EMineGridMapCell::MGMC_Zero);
+			ReplicateDelta();
+
+			// Act
+			AreaCells.UpdateCell(FIntPoint(0, 0), EMineGridMapCell::MGMC_Zero);
+			const bool bHasDelta = ReplicateDelta();
+
+			// Assert
+			TestFalse(TEXT("bHasDelta"), bHasDelta);
+			TestClientCells();
+		});
+
+		It("should fail on rect reaching past int32 coords, applying no cell", [this]() {
+			// Prepare, no removed cells and single rect block 6 cells wide starting 3 cells before largest coords
+			FBitWriter Writer(0, true);
+
+			uint32 GivenNumRemovedBlocks = 0;
+			uint32 GivenNumBlocks = 1;
+			uint32 GivenHeader = 1;
+			uint32 GivenDeltaX = (uint32)(MAX_int32 - 3) << 1;
+			uint32 GivenDeltaY = 0;
+			uint32 GivenWidth = 5;
+			uint32 GivenHeight = 0;
+			uint32 GivenNumValues = 0;
+			for (uint32* Value : { &GivenNumRemovedBlocks, &GivenNumBlocks, &GivenHeader, &GivenDeltaX, &GivenDeltaY, &GivenWidth, &GivenHeight, &GivenNumValues })
+			{
+				Writer.SerializeIntPacked(*Value);
+			}
+
+			// Act
+			FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+			FNetDeltaSerializeInfo ReadParms;
+			ReadParms.Reader = &Reader;
+			const bool bSuccess = ClientCells.NetDeltaSerialize(ReadParms);
+
+			// Assert
+			TestFalse(TEXT("bSuccess"), bSuccess);
+			TestTrue(TEXT("Reader.IsError()"), Reader.IsError());
+			TestEqual(TEXT("ClientCells.Items.Num()"), ClientCells.Items.Num(), 0);
+		});
+
+		It("should fail on fewer values than changed cells, applying no cell", [this]() {
+			// Prepare, no removed cells and two sparse cells with single value
+			FBitWriter Writer(0, true);
+
+			uint32 GivenNumRemovedBlocks = 0;
+			uint32 GivenNumBlocks = 1;
+			uint32 GivenHeader = 2 << 1;
+			uint32 GivenDeltas[] = { 2, 2, 2, 0 };
+			uint32 GivenNumValues = 1;
+			uint8 GivenPackedValues = (uint8)EMineGridMapCell::MGMC_One;
+			for (uint32* Value : { &GivenNumRemovedBlocks, &GivenNumBlocks, &GivenHeader, &GivenDeltas[0], &GivenDeltas[1], &GivenDeltas[2], &GivenDeltas[3], &GivenNumValues })
+			{
+				Writer.SerializeIntPacked(*Value);
+			}
+			Writer << GivenPackedValues;
+
+			// Act
+			FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+			FNetDeltaSerializeInfo ReadParms;
+			ReadParms.Reader = &Reader;
+			const bool bSuccess = ClientCells.NetDeltaSerialize(ReadParms);
+
+			// Assert
+			TestFalse(TEXT("bSuccess"), bSuccess);
+			TestEqual(TEXT("ClientCells.Items.Num()"), ClientCells.Items.Num(), 0);
+			TestEqual(TEXT("ClientCells.ReplicatedCells.Num()"), ClientCells.ReplicatedCells.Num(), 0);
+		});
+	});
+}
@@ -0,0 +1,52 @@
+#include "Misc/AutomationTest.h"
+#include "Minesweeper/Includes/MineGridMapJournal.h"
+
+BEGIN_DEFINE_SPEC(FMineGridMapJournalTest, "Minesweeper.MineGridMapJournal", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+	FMineGridMapJournal Journal;
+
+	TArray<FIntPoint> ReplaySince(const int32 Version)
+	{
+		TArray<FIntPoint> ReplayedCoords;
+		Journal.ForEachSince(Version, [&ReplayedCoords](const FIntPoint& Coords, const EMineGridMapCell Value) {
+			ReplayedCoords.Add(Coords);
+		});
+		return ReplayedCoords;
+	}
+END_DEFINE_SPEC(FMineGridMapJournalTest)
+
+void FMineGridMapJournalTest::Define()
+{
+	Describe("ForEachSince", [this]() {
+		BeforeEach([this]() {
+			Journal.Reset(0, 4);
+		});
+
+		It("should replay only changes after given version", [this]() {
+			// Prepare
+			Journal.Append(1, FIntPoint(0, 0), EMineGridMapCell::MGMC_One);
+			Journal.Append(2, FIntPoint(1, 0), EMineGridMapCell::MGMC_Two);
+			Journal.Append(2, FIntPoint(2, 0), EMineGridMapCell::MGMC_Zero);
+
+			// Act
+			const bool bCanReplay = Journal.CanReplaySince(1, 2);
+			const TArray<FIntPoint> ReplayedCoords = ReplaySince(1);
+
+			// Assert
+			TestTrue(TEXT("bCanReplay"), bCanReplay);
+			TestEqual(TEXT("ReplayedCoords"), ReplayedCoords, TArray<FIntPoint>({ FIntPoint(1, 0), FIntPoint(2, 0) }));
+		});
+
+		It("should refuse versions whose changes are overwritten", [this]() {
+			// Prepare
+			for (int32 Version = 1; Version <= 6; Version++)
+			{
+				Journal.Append(Version, FIntPoint(Version, 0), EMineGridMapCell::MGMC_One);
+			}
+
+			// Act & Assert
+			TestFalse(TEXT("CanReplaySince(1, 6)"), Journal.CanReplaySince(1, 6));
+			TestTrue(TEXT("CanReplaySince(2, 6)"), Journal.CanReplaySince(2, 6));
+			TestEqual(TEXT("ReplaySince(2)"), ReplaySince(2), TArray<FIntPoint>({ FIntPoint(3, 0), FIntPoint(4, 0), FIntPoint(5, 0), FIntPoint(6, 0) }));
+		});
+	});
+}
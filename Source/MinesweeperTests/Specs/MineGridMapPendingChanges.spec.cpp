@@ -0,0 +1,124 @@
+#include "Misc/AutomationTest.h"
+#include "Minesweeper/Includes/MineGridMapPendingChanges.h"
+
+BEGIN_DEFINE_SPEC(FMineGridMapPendingChangesTest, "Minesweeper.MineGridMapPendingChanges", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+	FMineGridMapPendingChanges PendingChanges;
+END_DEFINE_SPEC(FMineGridMapPendingChangesTest)
+
+void FMineGridMapPendingChangesTest::Define()
+{
+	Describe("Consume", [this]() {
+		BeforeEach([this]() {
+			PendingChanges = FMineGridMapPendingChanges();
+		});
+
+		It("should cancel out cells added and removed", [this]() {
+			// Prepare
+			PendingChanges.AddCell(FIntPoint(0, 0), EMineGridMapCell::MGMC_Undiscovered);
+			PendingChanges.UpdateCell(FIntPoint(0, 0), EMineGridMapCell::MGMC_One);
+			PendingChanges.RemoveCell(FIntPoint(0, 0));
+
+			// Act
+			FMineGridMapChanges GridMapChanges;
+			FMineGridMapCellUpdates CellUpdates;
+			PendingChanges.Consume(GridMapChanges, CellUpdates);
+
+			// Assert
+			TestEqual(TEXT("AddedGridMapCellCoords.Num()"), GridMapChanges.AddedGridMapCellCoords.Num(), 0);
+			TestEqual(TEXT("RemovedGridMapCells.Num()"), GridMapChanges.RemovedGridMapCells.Num(), 0);
+			TestEqual(TEXT("UpdatedGridMapCellCoords.Num()"), CellUpdates.UpdatedGridMapCellCoords.Num(), 0);
+			TestTrue(TEXT("IsEmpty()"), PendingChanges.IsEmpty());
+		});
+
+		It("should merge updates into added and removed-then-added cells", [this]() {
+			// Prepare
+			PendingChanges.AddCell(FIntPoint(0, 0), EMineGridMapCell::MGMC_Undiscovered);
+			PendingChanges.UpdateCell(FIntPoint(0, 0), EMineGridMapCell::MGMC_Two);
+			PendingChanges.RemoveCell(FIntPoint(1, 0));
+			PendingChanges.AddCell(FIntPoint(1, 0), EMineGridMapCell::MGMC_Three);
+			PendingChanges.UpdateCell(FIntPoint(2, 0), EMineGridMapCell::MGMC_One);
+			PendingChanges.UpdateCell(FIntPoint(2, 0), EMineGridMapCell::MGMC_Zero);
+
+			// Act
+			FMineGridMapChanges GridMapChanges;
+			FMineGridMapCellUpdates CellUpdates;
+			PendingChanges.Consume(GridMapChanges, CellUpdates);
+
+			// Assert
+			TestEqual(TEXT("AddedGridMapCellCoords"), GridMapChanges.AddedGridMapCellCoords, TArray<FIntPoint>({ FIntPoint(0, 0) }));
+			TestEqual(TEXT("AddedGridMapCellValues"), GridMapChanges.AddedGridMapCellValues, TArray<EMineGridMapCell>({ EMineGridMapCell::MGMC_Two }));
+			TestEqual(TEXT("RemovedGridMapCells.Num()"), GridMapChanges.RemovedGridMapCells.Num(), 0);
+			TestEqual(TEXT("UpdatedGridMapCellCoords.Num()"), CellUpdates.UpdatedGridMapCellCoords.Num(), 2);
+
+			for (int32 UpdatedIndex = 0; UpdatedIndex < CellUpdates.UpdatedGridMapCellCoords.Num(); UpdatedIndex++)
+			{
+				const FIntPoint& Coords = CellUpdates.UpdatedGridMapCellCoords[UpdatedIndex];
+				const EMineGridMapCell ExpectedValue = Coords == FIntPoint(1, 0) ? EMineGridMapCell::MGMC_Three : EMineGridMapCell::MGMC_Zero;
+				TestEqual(TEXT("UpdatedGridMapCellValues"), CellUpdates.UpdatedGridMapCellValues[UpdatedIndex], ExpectedValue);
+			}
+		});
+	});
+
+	Describe("Append", [this]() {
+		BeforeEach([this]() {
+			PendingChanges = FMineGridMapPendingChanges();
+		});
+
+		It("should hold changes of moving area in window slots", [this]() {
+			// Prepare
+			FMineGridMapChanges FirstGridMapChanges;
+			FirstGridMapChanges.NewGridDimensions = FIntPoint(3, 1);
+			FirstGridMapChanges.RemovedGridMapCells.Add(FIntPoint(0, 0));
+			FirstGridMapChanges.AddedGridMapCellCoords.Add(FIntPoint(3, 0));
+			FirstGridMapChanges.AddedGridMapCellValues.Add(EMineGridMapCell::MGMC_Undiscovered);
+
+			FMineGridMapChanges SecondGridMapChanges = FirstGridMapChanges;
+			SecondGridMapChanges.RemovedGridMapCells[0] = FIntPoint(1, 0);
+			SecondGridMapChanges.AddedGridMapCellCoords[0] = FIntPoint(4, 0);
+
+			// Act
+			PendingChanges.Append(FirstGridMapChanges);
+			PendingChanges.Append(SecondGridMapChanges);
+
+			// Assert
+			TestEqual(TEXT("Num()"), PendingChanges.Num(), 4);
+			TestEqual(TEXT("NumRemovedCells"), PendingChanges.NumRemovedCells, 2);
+			TestEqual(TEXT("PendingCells.OverflowValues.Num()"), PendingChanges.PendingCells.OverflowValues.Num(), 0);
+		});
+	});
+
+	Describe("ConsumeNearest", [this]() {
+		BeforeEach([this]() {
+			PendingChanges = FMineGridMapPendingChanges();
+			for (int32 X = -4; X <= 4; X++)
+			{
+				PendingChanges.AddCell(FIntPoint(X, 0), EMineGridMapCell::MGMC_Undiscovered);
+			}
+		});
+
+		It("should move out cells nearest to origin and ahead of heading first", [this]() {
+			// Act
+			FMineGridMapChanges GridMapChanges;
+			FMineGridMapCellUpdates CellUpdates;
+			PendingChanges.ConsumeNearest(FIntPoint(0, 0), FVector2D(1.f, 0.f), 2, GridMapChanges, CellUpdates);
+
+			// Assert, (1, 0) ahead counting as nearer than (-1, 0) behind
+			TestEqual(TEXT("AddedGridMapCellCoords"), GridMapChanges.AddedGridMapCellCoords, TArray<FIntPoint>({ FIntPoint(0, 0), FIntPoint(1, 0) }));
+			TestEqual(TEXT("Num()"), PendingChanges.Num(), 7);
+		});
+
+		It("should move out cells as near as each other in row order", [this]() {
+			// Prepare, (0, -1) being as near as (-1, 0) and (2, 0) ahead
+			PendingChanges.AddCell(FIntPoint(0, -1), EMineGridMapCell::MGMC_Undiscovered);
+
+			// Act
+			FMineGridMapChanges GridMapChanges;
+			FMineGridMapCellUpdates CellUpdates;
+			PendingChanges.ConsumeNearest(FIntPoint(0, 0), FVector2D(1.f, 0.f), 4, GridMapChanges, CellUpdates);
+
+			// Assert
+			TestEqual(TEXT("AddedGridMapCellCoords"), GridMapChanges.AddedGridMapCellCoords, TArray<FIntPoint>({ FIntPoint(0, 0), FIntPoint(1, 0), FIntPoint(0, -1), FIntPoint(-1, 0) }));
+			TestEqual(TEXT("Num()"), PendingChanges.Num(), 6);
+		});
+	});
+}
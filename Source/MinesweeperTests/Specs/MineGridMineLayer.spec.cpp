@@ -0,0 +1,193 @@
+#include "Misc/AutomationTest.h"
+#include "Minesweeper/Includes/MineGridMineLayer.h"
+
+BEGIN_DEFINE_SPEC(FMineGridMineLayerTest, "Minesweeper.MineGridMineLayer", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+	FMineGridMineLayer MineLayer;
+
+	uint8 CountMinesAround(const FIntPoint& Coords)
+	{
+		uint8 MinesCount = 0;
+		for (int32 Y = Coords.Y - 1; Y <= Coords.Y + 1; Y++)
+		{
+			for (int32 X = Coords.X - 1; X <= Coords.X + 1; X++)
+			{
+				const FIntPoint CellCoords(X, Y);
+				if (CellCoords != Coords && X >= 0 && Y >= 0 && X < MineLayer.GridDimensions.X && Y < MineLayer.GridDimensions.Y && MineLayer.IsMine(CellCoords))
+				{
+					MinesCount++;
+				}
+			}
+		}
+		return MinesCount;
+	}
+END_DEFINE_SPEC(FMineGridMineLayerTest)
+
+void FMineGridMineLayerTest::Define()
+{
+	Describe("ComputeAdjacentMineCounts", [this]() {
+		// Widths around bitboard word and vector lane boundaries
+		TTuple<FIntPoint, int32, FString> GivenData[] = {
+			MakeTuple(FIntPoint(1, 1), 2, TEXT("single cell")),
+			MakeTuple(FIntPoint(5, 4), 6, TEXT("base map")),
+			MakeTuple(FIntPoint(63, 7), 3, TEXT("below word width")),
+			MakeTuple(FIntPoint(65, 7), 3, TEXT("above word width")),
+			MakeTuple(FIntPoint(160, 128), 6, TEXT("largest map")),
+			MakeTuple(FIntPoint(300, 9), 1, TEXT("every cell mined")),
+		};
+
+		for (auto& DataRow : GivenData)
+		{
+			FIntPoint GivenDimensions;
+			int32 GivenMineOneIn;
+			FString DataRowDesc;
+
+			Tie(GivenDimensions, GivenMineOneIn, DataRowDesc) = DataRow;
+
+			It(FString::Printf(TEXT("should count the same mines with vector and scalar kernels, %s"), *DataRowDesc), [this, GivenDimensions, GivenMineOneIn]() {
+				// Prepare
+				FRandomStream RandomStream(GivenDimensions.X * 7919 + GivenDimensions.Y);
+
+				MineLayer.Init(GivenDimensions);
+				for (int32 Y = 0; Y < GivenDimensions.Y; Y++) {
+					for (int32 X = 0; X < GivenDimensions.X; X++) {
+						if (RandomStream.RandRange(1, GivenMineOneIn) == 1) {
+							MineLayer.SetMine(FIntPoint(X, Y));
+						}
+					}
+				}
+
+				// Act
+				MineLayer.ComputeAdjacentMineCounts(true);
+				const TArray<uint8> VectorCounts = MineLayer.AdjacentMineCounts;
+
+				MineLayer.ComputeAdjacentMineCounts(false);
+				const TArray<uint8> ScalarCounts = MineLayer.AdjacentMineCounts;
+
+				// Assert
+				TestTrue(TEXT("VectorCounts == ScalarCounts"), VectorCounts == ScalarCounts);
+
+				int32 NumMismatchedCells = 0;
+				for (int32 Y = 0; Y < GivenDimensions.Y; Y++) {
+					for (int32 X = 0; X < GivenDimensions.X; X++) {
+						if (MineLayer.GetAdjacentMineCount(FIntPoint(X, Y)) != CountMinesAround(FIntPoint(X, Y))) {
+							NumMismatchedCells++;
+						}
+					}
+				}
+				TestEqual(TEXT("NumMismatchedCells"), NumMismatchedCells, 0);
+			});
+		}
+	});
+
+	Describe("InitProcedural", [this]() {
+		It("should place exact number of mines and keep them when materialized", [this]() {
+			// Prepare
+			const FIntPoint GivenDimensions(160, 128);
+			const int32 GivenNumMines = GivenDimensions.X * GivenDimensions.Y / 6;
+
+			FMineGridMineGenerator MineGenerator;
+			MineGenerator.Init(GivenDimensions, 1234, GivenNumMines);
+
+			// Act
+			MineLayer.InitProcedural(MineGenerator);
+			const FMineGridMineLayer ProceduralMineLayer = MineLayer;
+			MineLayer.Materialize();
+
+			// Assert
+			int32 NumProceduralMines = 0;
+			int32 NumMismatchedCells = 0;
+			for (int32 Y = 0; Y < GivenDimensions.Y; Y++) {
+				for (int32 X = 0; X < GivenDimensions.X; X++) {
+					NumProceduralMines += (int32)ProceduralMineLayer.IsMine(FIntPoint(X, Y));
+					if (ProceduralMineLayer.IsMine(FIntPoint(X, Y)) != MineLayer.IsMine(FIntPoint(X, Y))) {
+						NumMismatchedCells++;
+					}
+				}
+			}
+			TestEqual(TEXT("NumProceduralMines"), NumProceduralMines, GivenNumMines);
+			TestEqual(TEXT("NumMines"), MineLayer.NumMines, GivenNumMines);
+			TestEqual(TEXT("NumMismatchedCells"), NumMismatchedCells, 0);
+		});
+
+		// Chunks of mines around number of mines placed by one parallel task
+		TTuple<FIntPoint, int32, FString> GivenData[] = {
+			MakeTuple(FIntPoint(65, 9), 100, TEXT("single chunk")),
+			MakeTuple(FIntPoint(640, 512), 640 * 512 / 6, TEXT("many chunks")),
+			MakeTuple(FIntPoint(300, 200), 300 * 200, TEXT("every cell mined")),
+		};
+
+		for (auto& DataRow : GivenData)
+		{
+			FIntPoint GivenDimensions;
+			int32 GivenNumMines;
+			FString DataRowDesc;
+
+			Tie(GivenDimensions, GivenNumMines, DataRowDesc) = DataRow;
+
+			It(FString::Printf(TEXT("should materialize the same mines in parallel as placed one by one, %s"), *DataRowDesc), [this, GivenDimensions, GivenNumMines]() {
+				// Prepare
+				FMineGridMineGenerator MineGenerator;
+				MineGenerator.Init(GivenDimensions, 2024, GivenNumMines);
+				MineGenerator.SetSafeBounds(FIntRect(FIntPoint(10, 3), FIntPoint(12, 5)));
+
+				FMineGridMineLayer SingleThreadedMineLayer;
+				SingleThreadedMineLayer.Init(GivenDimensions);
+				MineGenerator.ForEachMine([&SingleThreadedMineLayer](const FIntPoint& Coords) { SingleThreadedMineLayer.SetMine(Coords); });
+
+				// Act, several times so that different scheduling of chunks is likely
+				bool bIsEveryMaterializationEqual = true;
+				for (int32 Attempt = 0; Attempt < 4; Attempt++)
+				{
+					MineLayer.InitProcedural(MineGenerator);
+					MineLayer.Materialize();
+
+					bIsEveryMaterializationEqual &= MineLayer.MineRows == SingleThreadedMineLayer.MineRows && MineLayer.NumMines == SingleThreadedMineLayer.NumMines;
+				}
+
+				// Assert
+				TestTrue(TEXT("bIsEveryMaterializationEqual"), bIsEveryMaterializationEqual);
+				TestEqual(TEXT("NumMines"), MineLayer.NumMines, MineGenerator.NumMines);
+			});
+		}
+
+		It("should place the same mines given the same seed", [this]() {
+			// Prepare
+			const FIntPoint GivenDimensions(65, 9);
+
+			FMineGridMineGenerator MineGenerator, OtherMineGenerator;
+			MineGenerator.Init(GivenDimensions, 42, 100);
+			OtherMineGenerator.Init(GivenDimensions, 42, 100);
+
+			// Act
+			TArray<FIntPoint> MineCoords, OtherMineCoords;
+			MineGenerator.ForEachMine([&MineCoords](const FIntPoint& Coords) { MineCoords.Add(Coords); });
+			OtherMineGenerator.ForEachMine([&OtherMineCoords](const FIntPoint& Coords) { OtherMineCoords.Add(Coords); });
+
+			// Assert
+			TestTrue(TEXT("MineCoords == OtherMineCoords"), MineCoords == OtherMineCoords);
+		});
+
+		It("should drop mines inside of safe bounds only", [this]() {
+			// Prepare
+			const FIntPoint GivenDimensions(5, 4);
+			const FIntRect GivenSafeBounds(FIntPoint(1, 1), FIntPoint(3, 3));
+
+			FMineGridMineGenerator MineGenerator;
+			MineGenerator.Init(GivenDimensions, 7, GivenDimensions.X * GivenDimensions.Y);
+			MineLayer.InitProcedural(MineGenerator);
+
+			// Act
+			MineLayer.SetSafeBounds(GivenSafeBounds);
+
+			// Assert
+			int32 NumSafeMines = 0;
+			for (int32 Y = GivenSafeBounds.Min.Y; Y <= GivenSafeBounds.Max.Y; Y++) {
+				for (int32 X = GivenSafeBounds.Min.X; X <= GivenSafeBounds.Max.X; X++) {
+					NumSafeMines += (int32)MineLayer.IsMine(FIntPoint(X, Y));
+				}
+			}
+			TestEqual(TEXT("NumSafeMines"), NumSafeMines, 0);
+			TestEqual(TEXT("NumMines"), MineLayer.NumMines, 20 - 9);
+		});
+	});
+}
@@ -0,0 +1,42 @@
+#include "Misc/AutomationTest.h"
+#include "Minesweeper/Includes/MineGridTraversal.h"
+
+BEGIN_DEFINE_SPEC(FMineGridTraversalTest, "Minesweeper.MineGridTraversal", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+	TArray<FIntPoint> TraverseSegment(const FVector2D& Start, const FVector2D& End)
+	{
+		TArray<FIntPoint> VisitedCoords;
+		MineGridTraversal::ForEachCellOnSegment(Start, End, [&VisitedCoords](const FIntPoint& Coords) {
+			VisitedCoords.Add(Coords);
+		});
+		return VisitedCoords;
+	}
+END_DEFINE_SPEC(FMineGridTraversalTest)
+
+void FMineGridTraversalTest::Define()
+{
+	Describe("ForEachCellOnSegment", [this]() {
+		It("should visit nothing while staying inside of same cell", [this]() {
+			// Act
+			const TArray<FIntPoint> VisitedCoords = TraverseSegment(FVector2D(1.2f, 1.2f), FVector2D(1.8f, 1.9f));
+
+			// Assert
+			TestEqual(TEXT("VisitedCoords.Num()"), VisitedCoords.Num(), 0);
+		});
+
+		It("should visit every cell of long straight move once", [this]() {
+			// Act
+			const TArray<FIntPoint> VisitedCoords = TraverseSegment(FVector2D(0.5f, 2.5f), FVector2D(4.5f, 2.5f));
+
+			// Assert
+			TestEqual(TEXT("VisitedCoords"), VisitedCoords, TArray<FIntPoint>({ FIntPoint(1, 2), FIntPoint(2, 2), FIntPoint(3, 2), FIntPoint(4, 2) }));
+		});
+
+		It("should visit cells of diagonal move in order, ending at end cell", [this]() {
+			// Act
+			const TArray<FIntPoint> VisitedCoords = TraverseSegment(FVector2D(2.8f, 2.6f), FVector2D(0.4f, 0.1f));
+
+			// Assert
+			TestEqual(TEXT("VisitedCoords"), VisitedCoords, TArray<FIntPoint>({ FIntPoint(2, 1), FIntPoint(1, 1), FIntPoint(1, 0), FIntPoint(0, 0) }));
+		});
+	});
+}
@@ -0,0 +1,70 @@
+#include "Misc/AutomationTest.h"
+#include "Minesweeper/Includes/MineGridWindow.h"
+
+BEGIN_DEFINE_SPEC(FMineGridWindowTest, "Minesweeper.MineGridWindow", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+	TMineGridWindow<int32> Window;
+END_DEFINE_SPEC(FMineGridWindowTest)
+
+void FMineGridWindowTest::Define()
+{
+	Describe("Add", [this]() {
+		BeforeEach([this]() {
+			Window = TMineGridWindow<int32>();
+			Window.Reserve(FIntPoint(3, 3));
+		});
+
+		It("should reuse wrapped slots while window moves, never overflowing", [this]() {
+			// Prepare
+			for (int32 X = -1; X <= 2; X++)
+			{
+				Window.Add(FIntPoint(X, 0), X);
+			}
+
+			// Act, moving window right by many columns
+			for (int32 X = -1; X < 20; X++)
+			{
+				Window.Remove(FIntPoint(X, 0));
+				Window.Add(FIntPoint(X + 4, 0), X + 4);
+			}
+
+			// Assert
+			TestEqual(TEXT("OverflowValues.Num()"), Window.OverflowValues.Num(), 0);
+			TestEqual(TEXT("Num()"), Window.Num(), 4);
+			TestFalse(TEXT("Contains(0, 0)"), Window.Contains(FIntPoint(0, 0)));
+			TestEqual(TEXT("FindChecked(22, 0)"), Window.FindChecked(FIntPoint(22, 0)), 22);
+		});
+
+		It("should keep aliasing value in overflow until it is removed", [this]() {
+			// Prepare
+			const int32 WindowWidth = Window.Dimensions.X;
+			Window.Add(FIntPoint(0, 0), 1);
+
+			// Act
+			Window.Add(FIntPoint(WindowWidth, 0), 2);
+			const int32 NumOverflowValuesBeforeRemove = Window.OverflowValues.Num();
+
+			int32 RemovedValue = 0;
+			Window.RemoveAndCopyValue(FIntPoint(WindowWidth, 0), RemovedValue);
+
+			// Assert
+			TestEqual(TEXT("NumOverflowValuesBeforeRemove"), NumOverflowValuesBeforeRemove, 1);
+			TestEqual(TEXT("RemovedValue"), RemovedValue, 2);
+			TestEqual(TEXT("OverflowValues.Num()"), Window.OverflowValues.Num(), 0);
+			TestEqual(TEXT("FindChecked(0, 0)"), Window.FindChecked(FIntPoint(0, 0)), 1);
+		});
+
+		It("should move values into slots when grown", [this]() {
+			// Prepare
+			Window.Add(FIntPoint(0, 0), 1);
+			Window.Add(FIntPoint(4, 0), 2);
+
+			// Act
+			Window.Reserve(FIntPoint(8, 4));
+
+			// Assert
+			TestEqual(TEXT("OverflowValues.Num()"), Window.OverflowValues.Num(), 0);
+			TestEqual(TEXT("FindChecked(0, 0)"), Window.FindChecked(FIntPoint(0, 0)), 1);
+			TestEqual(TEXT("FindChecked(4, 0)"), Window.FindChecked(FIntPoint(4, 0)), 2);
+		});
+	});
+}
@@ -0,0 +1,209 @@
+#include "Misc/AutomationTest.h"
+#include "Minesweeper/Includes/MineGridZeroRegionIndex.h"
+
+BEGIN_DEFINE_SPEC(FMineGridZeroRegionIndexTest, "Minesweeper.MineGridZeroRegionIndex", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+	FMineGridMineLayer MineLayer;
+	FMineGridZeroRegionIndex ZeroRegionIndex;
+
+	void InitMineLayer(const FIntPoint& Dimensions, const TArray<FIntPoint>& MineCoords)
+	{
+		MineLayer.Init(Dimensions);
+		for (const FIntPoint& Coords : MineCoords)
+		{
+			MineLayer.SetMine(Coords);
+		}
+		MineLayer.ComputeAdjacentMineCounts();
+	}
+
+	int32 GetCellIndex(const FIntPoint& Coords) const
+	{
+		return Coords.Y * MineLayer.RowStride + Coords.X;
+	}
+
+	/** Cells opened by stepping onto given cell, found by breadth-first cascade */
+	TSet<int32> CascadeOpenedCells(const FIntPoint& EnteredCoords)
+	{
+		TSet<int32> OpenedCells;
+
+		TQueue<FIntPoint> RemainingCells;
+		RemainingCells.Enqueue(EnteredCoords);
+
+		FIntPoint RemainingCellCoords;
+		while (RemainingCells.Dequeue(RemainingCellCoords))
+		{
+			if (OpenedCells.Contains(GetCellIndex(RemainingCellCoords)))
+			{
+				continue;
+			}
+			OpenedCells.Add(GetCellIndex(RemainingCellCoords));
+
+			if (MineLayer.GetAdjacentMineCount(RemainingCellCoords) > 0)
+			{
+				continue;
+			}
+
+			for (int32 Y = FMath::Max(RemainingCellCoords.Y - 1, 0); Y <= FMath::Min(RemainingCellCoords.Y + 1, MineLayer.GridDimensions.Y - 1); Y++)
+			{
+				for (int32 X = FMath::Max(RemainingCellCoords.X - 1, 0); X <= FMath::Min(RemainingCellCoords.X + 1, MineLayer.GridDimensions.X - 1); X++)
+				{
+					RemainingCells.Enqueue(FIntPoint(X, Y));
+				}
+			}
+		}
+
+		return OpenedCells;
+	}
+END_DEFINE_SPEC(FMineGridZeroRegionIndexTest)
+
+void FMineGridZeroRegionIndexTest::Define()
+{
+	Describe("Build", [this]() {
+		It("should label regions separated by mines", [this]() {
+			// Prepare
+			//
+			//  ·····*····
+			//  ·····*····
+			//  *****·····
+			//  ··········
+			InitMineLayer(FIntPoint(10, 4), { FIntPoint(5, 0), FIntPoint(5, 1), FIntPoint(0, 2), FIntPoint(1, 2), FIntPoint(2, 2), FIntPoint(3, 2), FIntPoint(4, 2) });
+
+			// Act
+			ZeroRegionIndex.Build(MineLayer);
+
+			// Assert
+			TestTrue(TEXT("IsBuilt"), ZeroRegionIndex.IsBuilt());
+			TestEqual(TEXT("NumRegions"), ZeroRegionIndex.NumRegions(), 2);
+
+			// Regions are numbered by their first cell
+			TestEqual(TEXT("GetRegionAt(0, 0)"), ZeroRegionIndex.GetRegionAt(GetCellIndex(FIntPoint(0, 0))), 0);
+			TestEqual(TEXT("GetRegionAt(3, 0)"), ZeroRegionIndex.GetRegionAt(GetCellIndex(FIntPoint(3, 0))), 0);
+			TestEqual(TEXT("GetRegionAt(7, 0)"), ZeroRegionIndex.GetRegionAt(GetCellIndex(FIntPoint(7, 0))), 1);
+			TestEqual(TEXT("GetRegionAt(9, 3)"), ZeroRegionIndex.GetRegionAt(GetCellIndex(FIntPoint(9, 3))), 1);
+			TestEqual(TEXT("GetRegionAt(6, 3)"), ZeroRegionIndex.GetRegionAt(GetCellIndex(FIntPoint(6, 3))), 1);
+
+			// Numbered and mined cells are not members
+			TestEqual(TEXT("GetRegionAt(0, 3)"), ZeroRegionIndex.GetRegionAt(GetCellIndex(FIntPoint(0, 3))), INDEX_NONE);
+			TestEqual(TEXT("GetRegionAt(4, 0)"), ZeroRegionIndex.GetRegionAt(GetCellIndex(FIntPoint(4, 0))), INDEX_NONE);
+			TestEqual(TEXT("GetRegionAt(5, 0)"), ZeroRegionIndex.GetRegionAt(GetCellIndex(FIntPoint(5, 0))), INDEX_NONE);
+			TestEqual(TEXT("GetRegionAt(3, 3)"), ZeroRegionIndex.GetRegionAt(GetCellIndex(FIntPoint(3, 3))), INDEX_NONE);
+
+			TestEqual(TEXT("RegionNumMembers[0]"), ZeroRegionIndex.RegionNumMembers[0], 4);
+			TestEqual(TEXT("GetRegionCells(0).Num()"), ZeroRegionIndex.GetRegionCells(0).Num(), 4 + 6);
+		});
+
+		It("should label no regions if every cell has mines around", [this]() {
+			// Prepare
+			InitMineLayer(FIntPoint(3, 3), { FIntPoint(1, 1) });
+
+			// Act
+			ZeroRegionIndex.Build(MineLayer);
+
+			// Assert
+			TestTrue(TEXT("IsBuilt"), ZeroRegionIndex.IsBuilt());
+			TestEqual(TEXT("NumRegions"), ZeroRegionIndex.NumRegions(), 0);
+			TestEqual(TEXT("GetRegionAt(0, 0)"), ZeroRegionIndex.GetRegionAt(GetCellIndex(FIntPoint(0, 0))), INDEX_NONE);
+		});
+
+		It("should build the same index regardless of scheduling of bands", [this]() {
+			// Prepare, rows spanning several bands
+			FMineGridMineGenerator MineGenerator;
+			MineGenerator.Init(FIntPoint(320, 256), 77, 320 * 256 / 8);
+			MineLayer.InitProcedural(MineGenerator);
+			MineLayer.Materialize();
+			MineLayer.ComputeAdjacentMineCounts();
+
+			ZeroRegionIndex.Build(MineLayer);
+			const FMineGridZeroRegionIndex FirstZeroRegionIndex = ZeroRegionIndex;
+
+			// Act
+			bool bIsEveryBuildEqual = true;
+			for (int32 Attempt = 0; Attempt < 4; Attempt++)
+			{
+				ZeroRegionIndex.Build(MineLayer);
+
+				bIsEveryBuildEqual &= ZeroRegionIndex.RunStartIndices == FirstZeroRegionIndex.RunStartIndices
+					&& ZeroRegionIndex.RunRegions == FirstZeroRegionIndex.RunRegions
+					&& ZeroRegionIndex.RegionOffsets == FirstZeroRegionIndex.RegionOffsets
+					&& ZeroRegionIndex.RegionCells == FirstZeroRegionIndex.RegionCells;
+			}
+
+			// Assert
+			TestTrue(TEXT("NumRegions > 0"), FirstZeroRegionIndex.NumRegions() > 0);
+			TestTrue(TEXT("bIsEveryBuildEqual"), bIsEveryBuildEqual);
+		});
+
+		// Widths around bitboard word boundaries
+		TTuple<FIntPoint, int32, FString> GivenData[] = {
+			MakeTuple(FIntPoint(1, 1), 2, TEXT("single cell")),
+			MakeTuple(FIntPoint(63, 17), 9, TEXT("below word width, sparse mines")),
+			MakeTuple(FIntPoint(65, 17), 4, TEXT("above word width, dense mines")),
+			MakeTuple(FIntPoint(160, 128), 6, TEXT("largest map")),
+		};
+
+		for (auto& DataRow : GivenData)
+		{
+			FIntPoint GivenDimensions;
+			int32 GivenMineOneIn;
+			FString DataRowDesc;
+
+			Tie(GivenDimensions, GivenMineOneIn, DataRowDesc) = DataRow;
+
+			It(FString::Printf(TEXT("should list the same cells as breadth-first cascade, %s"), *DataRowDesc), [this, GivenDimensions, GivenMineOneIn]() {
+				// Prepare
+				FRandomStream RandomStream(GivenDimensions.X * 7919 + GivenDimensions.Y);
+
+				TArray<FIntPoint> GivenMineCoords;
+				for (int32 Y = 0; Y < GivenDimensions.Y; Y++) {
+					for (int32 X = 0; X < GivenDimensions.X; X++) {
+						if (RandomStream.RandRange(1, GivenMineOneIn) == 1) {
+							GivenMineCoords.Add(FIntPoint(X, Y));
+						}
+					}
+				}
+				InitMineLayer(GivenDimensions, GivenMineCoords);
+
+				// Act
+				ZeroRegionIndex.Build(MineLayer);
+
+				// Assert
+				TArray<bool> IsRegionCompared;
+				IsRegionCompared.Init(false, ZeroRegionIndex.NumRegions());
+
+				int32 NumMislabelledCells = 0;
+				int32 NumMismatchedRegions = 0;
+				for (int32 Y = 0; Y < GivenDimensions.Y; Y++) {
+					for (int32 X = 0; X < GivenDimensions.X; X++) {
+						const FIntPoint CellCoords(X, Y);
+						const bool bIsMember = !MineLayer.IsMine(CellCoords) && MineLayer.GetAdjacentMineCount(CellCoords) == 0;
+						const int32 Region = ZeroRegionIndex.GetRegionAt(GetCellIndex(CellCoords));
+
+						if (bIsMember != (Region != INDEX_NONE)) {
+							NumMislabelledCells++;
+							continue;
+						}
+						if (!bIsMember || IsRegionCompared[Region]) {
+							continue;
+						}
+						IsRegionCompared[Region] = true;
+
+						const TArrayView<const int32> RegionCells = ZeroRegionIndex.GetRegionCells(Region);
+						const TSet<int32> ExpectedRegionCells = CascadeOpenedCells(CellCoords);
+
+						bool bIsMismatched = RegionCells.Num() != ExpectedRegionCells.Num();
+						for (int32 Index = 0; !bIsMismatched && Index < RegionCells.Num(); Index++) {
+							const int32 RegionCellIndex = RegionCells[Index];
+							const bool bIsMemberCell = MineLayer.GetAdjacentMineCountAt(RegionCellIndex) == 0;
+
+							// Members come first, followed by border
+							bIsMismatched = !ExpectedRegionCells.Contains(RegionCellIndex) || bIsMemberCell != (Index < ZeroRegionIndex.RegionNumMembers[Region]);
+						}
+						NumMismatchedRegions += (int32)bIsMismatched;
+					}
+				}
+				TestEqual(TEXT("NumMislabelledCells"), NumMislabelledCells, 0);
+				TestEqual(TEXT("NumMismatchedRegions"), NumMismatchedRegions, 0);
+				TestFalse(TEXT("IsRegionCompared.Contains(false)"), IsRegionCompared.Contains(false));
+			});
+		}
+	});
+}
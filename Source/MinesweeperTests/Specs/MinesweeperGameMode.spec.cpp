@@ -0,0 +1,372 @@
+#include "Misc/AutomationTest.h"
+#include "Minesweeper/GameMode/MinesweeperGameModeBase.h"
+#include "Minesweeper/Includes/MineGridRect.h"
+#include "Minesweeper/Player/MinesweeperPlayerControllerBase.h"
+
+BEGIN_DEFINE_SPEC(AMinesweeperGameModeTest, "Minesweeper.MinesweeperGameMode", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+	UWorld* World = nullptr;
+	AMinesweeperGameModeBase* GameMode = nullptr;
+
+	FStructProperty* MineLayerProperty;
+	FIntProperty* MaxDenseMapCellCountProperty;
+	FIntProperty* RemainingClearCellCountProperty;
+	FBoolProperty* IsGameOverProperty;
+	FIntProperty* GridMapAreaVersionProperty;
+
+	void StartNewGame(const uint8 MapSize, const int32 Seed, const float MineDensity)
+	{
+		struct { uint8 MapSize; int32 Seed; float MineDensity; } Params = { MapSize, Seed, MineDensity };
+		GameMode->ProcessEvent(GameMode->FindFunctionChecked(TEXT("HandleOnPlayerNewGame")), &Params);
+	}
+
+	void TriggerCoords(const FIntPoint& EnteredCoords)
+	{
+		struct { FIntPoint EnteredCoords; } Params = { EnteredCoords };
+		GameMode->ProcessEvent(GameMode->FindFunctionChecked(TEXT("HandleOnPlayerTriggeredCoords")), &Params);
+	}
+
+	/** First mine-free cell with mines around it inside of bounds (end-inclusive) */
+	FIntPoint FindNumberedCell(const FIntRect& Bounds)
+	{
+		const FMineGridMineLayer& MineLayer = *MineLayerProperty->ContainerPtrToValuePtr<FMineGridMineLayer>(GameMode);
+
+		for (int32 Y = Bounds.Min.Y; Y <= Bounds.Max.Y; Y++)
+		{
+			for (int32 X = Bounds.Min.X; X <= Bounds.Max.X; X++)
+			{
+				if (!MineLayer.IsMine(FIntPoint(X, Y)) && MineLayer.CountAdjacentMines(FIntPoint(X, Y)) > 0)
+				{
+					return FIntPoint(X, Y);
+				}
+			}
+		}
+		return AMinesweeperGameModeBase::DefaultCellCoords;
+	}
+
+	/** Cells opened by stepping onto given cell, as done by breadth-first cascade preceding scanline fill */
+	TSet<FIntPoint> CascadeOpenedCells(const FMineGridMineLayer& MineLayer, const FIntPoint& EnteredCoords)
+	{
+		TSet<FIntPoint> OpenedCells;
+
+		TQueue<FIntPoint> RemainingCells;
+		RemainingCells.Enqueue(EnteredCoords);
+
+		FIntPoint RemainingCellCoords;
+		while (RemainingCells.Dequeue(RemainingCellCoords))
+		{
+			if (OpenedCells.Contains(RemainingCellCoords))
+			{
+				continue;
+			}
+			OpenedCells.Add(RemainingCellCoords);
+
+			if (MineLayer.CountAdjacentMines(RemainingCellCoords) > 0)
+			{
+				continue;
+			}
+
+			for (int32 Y = FMath::Max(RemainingCellCoords.Y - 1, 0); Y <= FMath::Min(RemainingCellCoords.Y + 1, MineLayer.GridDimensions.Y - 1); Y++)
+			{
+				for (int32 X = FMath::Max(RemainingCellCoords.X - 1, 0); X <= FMath::Min(RemainingCellCoords.X + 1, MineLayer.GridDimensions.X - 1); X++)
+				{
+					RemainingCells.Enqueue(FIntPoint(X, Y));
+				}
+			}
+		}
+
+		return OpenedCells;
+	}
+END_DEFINE_SPEC(AMinesweeperGameModeTest)
+
+void AMinesweeperGameModeTest::Define()
+{
+	BeforeEach([this]() {
+		// Setup
+		World = UWorld::CreateWorld(EWorldType::Game, false);
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		FURL URL;
+		World->InitializeActorsForPlay(URL);
+		World->BeginPlay();
+
+		GameMode = NewObject<AMinesweeperGameModeBase>(World->PersistentLevel);
+
+		MineLayerProperty = FindFieldChecked<FStructProperty>(GameMode->GetClass(), TEXT("MineLayer"));
+		MaxDenseMapCellCountProperty = FindFieldChecked<FIntProperty>(GameMode->GetClass(), TEXT("MaxDenseMapCellCount"));
+		RemainingClearCellCountProperty = FindFieldChecked<FIntProperty>(GameMode->GetClass(), TEXT("RemainingClearCellCount"));
+		IsGameOverProperty = FindFieldChecked<FBoolProperty>(GameMode->GetClass(), TEXT("bIsGameOver"));
+		GridMapAreaVersionProperty = FindFieldChecked<FIntProperty>(AMinesweeperPlayerControllerBase::StaticClass(), TEXT("GridMapAreaVersion"));
+
+		// Players reach game mode as authority one
+		auto AuthorityGameModeProperty = FindFieldChecked<FObjectProperty>(UWorld::StaticClass(), TEXT("AuthorityGameMode"));
+		AuthorityGameModeProperty->SetObjectPropertyValue_InContainer(World, GameMode);
+	});
+
+	Describe("GenerateNewMap", [this]() {
+		It("should lay out the same mines given the same seed and density", [this]() {
+			// Prepare
+			StartNewGame(3, 4321, 0.25f);
+			const FMineGridMineLayer MineLayer = *MineLayerProperty->ContainerPtrToValuePtr<FMineGridMineLayer>(GameMode);
+
+			// Act
+			StartNewGame(3, 4321, 0.25f);
+			const FMineGridMineLayer OtherMineLayer = *MineLayerProperty->ContainerPtrToValuePtr<FMineGridMineLayer>(GameMode);
+
+			// Assert
+			int32 NumMismatchedCells = 0;
+			for (int32 Y = 0; Y < MineLayer.GridDimensions.Y; Y++) {
+				for (int32 X = 0; X < MineLayer.GridDimensions.X; X++) {
+					NumMismatchedCells += (int32)(MineLayer.IsMine(FIntPoint(X, Y)) != OtherMineLayer.IsMine(FIntPoint(X, Y)));
+				}
+			}
+			TestEqual(TEXT("OtherMineLayer.GridDimensions"), OtherMineLayer.GridDimensions, MineLayer.GridDimensions);
+			TestEqual(TEXT("OtherMineLayer.NumMines"), OtherMineLayer.NumMines, MineLayer.NumMines);
+			TestEqual(TEXT("NumMismatchedCells"), NumMismatchedCells, 0);
+		});
+
+		It("should round number of mines of given density", [this]() {
+			// Act, 80 cells of 0.16 density giving 12.8 mines
+			StartNewGame(1, 99, 0.16f);
+
+			// Assert
+			const FMineGridMineLayer& MineLayer = *MineLayerProperty->ContainerPtrToValuePtr<FMineGridMineLayer>(GameMode);
+
+			int32 NumPlacedMines = 0;
+			MineLayer.ForEachMine([&NumPlacedMines](const FIntPoint& Coords) { NumPlacedMines++; });
+
+			TestEqual(TEXT("MineLayer.NumMines"), MineLayer.NumMines, 13);
+			TestEqual(TEXT("NumPlacedMines"), NumPlacedMines, 13);
+		});
+	});
+
+	Describe("OpenCell", [this]() {
+		// Chunked maps open cells by scanline fill, dense maps by precomputed regions
+		TTuple<uint8, int32, bool, FString> GivenData[] = {
+			MakeTuple((uint8)1, 11, false, TEXT("small chunked map")),
+			MakeTuple((uint8)3, 12, false, TEXT("chunked map")),
+			MakeTuple((uint8)5, 13, false, TEXT("chunked map of many tiles")),
+			MakeTuple((uint8)1, 11, true, TEXT("small dense map")),
+			MakeTuple((uint8)3, 12, true, TEXT("dense map")),
+			MakeTuple((uint8)5, 13, true, TEXT("dense map of many rows")),
+		};
+
+		for (auto& DataRow : GivenData)
+		{
+			uint8 GivenMapSize;
+			int32 GivenSeed;
+			bool bGivenIsDense;
+			FString DataRowDesc;
+
+			Tie(GivenMapSize, GivenSeed, bGivenIsDense, DataRowDesc) = DataRow;
+
+			It(FString::Printf(TEXT("should open the same cells as breadth-first cascade, %s"), *DataRowDesc), [this, GivenMapSize, GivenSeed, bGivenIsDense]() {
+				// Prepare
+				*MaxDenseMapCellCountProperty->ContainerPtrToValuePtr<int32>(GameMode) = bGivenIsDense ? MAX_int32 : 0;
+
+				// Layouts of several seeds, each entered at up to 16 cells having no mines around
+				int32 NumComparedLayouts = 0;
+				int32 NumMismatchedLayouts = 0;
+
+				for (int32 SeedOffset = 0; SeedOffset < 8; SeedOffset++)
+				{
+					StartNewGame(GivenMapSize, GivenSeed * 100 + SeedOffset, 0.1f);
+
+					const FMineGridMineLayer MineLayer = *MineLayerProperty->ContainerPtrToValuePtr<FMineGridMineLayer>(GameMode);
+
+					TArray<FIntPoint> ZeroCells;
+					for (int32 Y = 0; Y < MineLayer.GridDimensions.Y; Y++) {
+						for (int32 X = 0; X < MineLayer.GridDimensions.X; X++) {
+							if (!MineLayer.IsMine(FIntPoint(X, Y)) && MineLayer.CountAdjacentMines(FIntPoint(X, Y)) == 0) {
+								ZeroCells.Add(FIntPoint(X, Y));
+							}
+						}
+					}
+
+					const int32 ZeroCellStep = FMath::Max(ZeroCells.Num() / 16, 1);
+					for (int32 ZeroCellIndex = 0; ZeroCellIndex < ZeroCells.Num(); ZeroCellIndex += ZeroCellStep)
+					{
+						const FIntPoint EnteredCoords = ZeroCells[ZeroCellIndex];
+
+						StartNewGame(GivenMapSize, GivenSeed * 100 + SeedOffset, 0.1f);
+						const TSet<FIntPoint> ExpectedOpenedCells = CascadeOpenedCells(MineLayer, EnteredCoords);
+						const int32 ExpectedRemainingClearCellCount = *RemainingClearCellCountProperty->ContainerPtrToValuePtr<int32>(GameMode) - ExpectedOpenedCells.Num();
+
+						// Act
+						TriggerCoords(EnteredCoords);
+
+						// Assert
+						const FMineGridMap& MineGridMap = GameMode->GetMineGridMap();
+
+						bool bIsMismatched = *RemainingClearCellCountProperty->ContainerPtrToValuePtr<int32>(GameMode) != ExpectedRemainingClearCellCount;
+						for (int32 Y = MineGridMap.StartCoords.Y; !bIsMismatched && Y <= MineGridMap.EndCoords.Y; Y++) {
+							for (int32 X = MineGridMap.StartCoords.X; !bIsMismatched && X <= MineGridMap.EndCoords.X; X++) {
+								const FIntPoint CellCoords(X, Y);
+								const EMineGridMapCell ExpectedCellValue = ExpectedOpenedCells.Contains(CellCoords)
+									? (EMineGridMapCell)MineLayer.CountAdjacentMines(CellCoords) : EMineGridMapCell::MGMC_Undiscovered;
+
+								bIsMismatched = MineGridMap.GetCell(CellCoords) != ExpectedCellValue;
+							}
+						}
+
+						NumComparedLayouts++;
+						NumMismatchedLayouts += (int32)bIsMismatched;
+					}
+				}
+
+				TestTrue(TEXT("NumComparedLayouts > 0"), NumComparedLayouts > 0);
+				TestEqual(TEXT("NumMismatchedLayouts"), NumMismatchedLayouts, 0);
+			});
+		}
+	});
+
+	Describe("HandleOnPlayerTriggeredCoords", [this]() {
+		It("should journal only final value of every cell on game over", [this]() {
+			// Prepare
+			StartNewGame(1, 23, 0.3f);
+
+			const FMineGridMineLayer& MineLayer = *MineLayerProperty->ContainerPtrToValuePtr<FMineGridMineLayer>(GameMode);
+			FIntPoint GivenMineCoords = FIntPoint::ZeroValue;
+			MineLayer.ForEachMine([&GivenMineCoords](const FIntPoint& Coords) { GivenMineCoords = Coords; });
+
+			// Act
+			TriggerCoords(GivenMineCoords);
+
+			// Assert
+			TMap<FIntPoint, int32> NumCellChanges;
+			TMap<FIntPoint, EMineGridMapCell> JournaledCells;
+			GameMode->GetMineGridMapJournal().ForEachSince(0, [&NumCellChanges, &JournaledCells](const FIntPoint& Coords, const EMineGridMapCell CellValue)
+			{
+				NumCellChanges.FindOrAdd(Coords)++;
+				JournaledCells.Add(Coords, CellValue);
+			});
+
+			int32 NumRepeatedCells = 0;
+			for (const TPair<FIntPoint, int32>& CellChanges : NumCellChanges)
+			{
+				NumRepeatedCells += (int32)(CellChanges.Value > 1);
+			}
+			TestEqual(TEXT("NumRepeatedCells"), NumRepeatedCells, 0);
+			TestEqual(TEXT("JournaledCells.Num()"), JournaledCells.Num(), MineLayer.NumMines);
+			TestTrue(TEXT("JournaledCells[GivenMineCoords] == MGMC_Exploded"), JournaledCells.FindRef(GivenMineCoords) == EMineGridMapCell::MGMC_Exploded);
+		});
+	});
+
+	Describe("SetPlayerViewBounds", [this]() {
+		It("should send new versions of grid map only to players seeing changed cells", [this]() {
+			// Prepare, map of 2x1 tiles with players in both of them
+			StartNewGame(4, 31, 0.2f);
+
+			const FIntPoint GivenCellCoords = FindNumberedCell(FIntRect(FIntPoint(4, 4), FIntPoint(20, 20)));
+			const FIntPoint OtherGivenCellCoords = FindNumberedCell(FIntRect(FIntPoint(40, 40), FIntPoint(56, 56)));
+
+			auto Player = NewObject<AMinesweeperPlayerControllerBase>(World->PersistentLevel);
+			auto SameTilePlayer = NewObject<AMinesweeperPlayerControllerBase>(World->PersistentLevel);
+			auto OtherTilePlayer = NewObject<AMinesweeperPlayerControllerBase>(World->PersistentLevel);
+
+			GameMode->SetPlayerViewBounds(Player, FIntRect(GivenCellCoords - 2, GivenCellCoords + 2));
+			GameMode->SetPlayerViewBounds(SameTilePlayer, FIntRect(OtherGivenCellCoords - 2, OtherGivenCellCoords + 2));
+			GameMode->SetPlayerViewBounds(OtherTilePlayer, FIntRect(FIntPoint(66, 10), FIntPoint(76, 20)));
+
+			auto GetVersion = [this](AMinesweeperPlayerControllerBase* Controller) { return *GridMapAreaVersionProperty->ContainerPtrToValuePtr<int32>(Controller); };
+
+			// Act & Assert
+			TriggerCoords(GivenCellCoords);
+
+			TestEqual(TEXT("Player version after trigger"), GetVersion(Player), 1);
+			TestEqual(TEXT("SameTilePlayer version after trigger"), GetVersion(SameTilePlayer), 0);
+			TestEqual(TEXT("OtherTilePlayer version after trigger"), GetVersion(OtherTilePlayer), 0);
+
+			// Player moving to other tile no longer sees changes in former one
+			GameMode->SetPlayerViewBounds(Player, FIntRect(FIntPoint(66, 30), FIntPoint(76, 40)));
+			TriggerCoords(OtherGivenCellCoords);
+
+			TestEqual(TEXT("Player version after other trigger"), GetVersion(Player), 1);
+			TestEqual(TEXT("SameTilePlayer version after other trigger"), GetVersion(SameTilePlayer), 2);
+			TestEqual(TEXT("OtherTilePlayer version after other trigger"), GetVersion(OtherTilePlayer), 0);
+
+			// Removed player is not sent anything
+			GameMode->RemovePlayerView(SameTilePlayer);
+			GameMode->SetPlayerViewBounds(Player, FIntRect(OtherGivenCellCoords - 3, OtherGivenCellCoords + 3));
+			TriggerCoords(FindNumberedCell(FIntRect(OtherGivenCellCoords + FIntPoint(1, 0), OtherGivenCellCoords + 3)));
+
+			TestEqual(TEXT("Player version after last trigger"), GetVersion(Player), 3);
+			TestEqual(TEXT("SameTilePlayer version after last trigger"), GetVersion(SameTilePlayer), 2);
+		});
+
+		It("should reveal mines coming into view of chunked map after game over", [this]() {
+			// Prepare
+			*MaxDenseMapCellCountProperty->ContainerPtrToValuePtr<int32>(GameMode) = 0;
+			StartNewGame(1, 17, 0.3f);
+			IsGameOverProperty->SetPropertyValue_InContainer(GameMode, true);
+
+			const FIntRect GivenViewBounds(FIntPoint(2, 1), FIntPoint(6, 4));
+			const FMineGridMineLayer& MineLayer = *MineLayerProperty->ContainerPtrToValuePtr<FMineGridMineLayer>(GameMode);
+			const int32 GivenVersion = GameMode->GetMineGridMapVersion();
+
+			// Act
+			GameMode->SetPlayerViewBounds(nullptr, GivenViewBounds);
+
+			// Assert
+			const FMineGridMap& MineGridMap = GameMode->GetMineGridMap();
+
+			int32 NumViewMines = 0;
+			int32 NumMismatchedCells = 0;
+			for (int32 Y = MineGridMap.StartCoords.Y; Y <= MineGridMap.EndCoords.Y; Y++) {
+				for (int32 X = MineGridMap.StartCoords.X; X <= MineGridMap.EndCoords.X; X++) {
+					const FIntPoint CellCoords(X, Y);
+					const bool bIsViewMine = MineLayer.IsMine(CellCoords) && MineGridRect::Contains(GivenViewBounds, CellCoords);
+					const EMineGridMapCell ExpectedCellValue = bIsViewMine ? EMineGridMapCell::MGMC_Revealed : EMineGridMapCell::MGMC_Undiscovered;
+
+					NumViewMines += (int32)bIsViewMine;
+					NumMismatchedCells += (int32)(MineGridMap.GetCell(CellCoords) != ExpectedCellValue);
+				}
+			}
+			TestTrue(TEXT("NumViewMines > 0"), NumViewMines > 0);
+			TestEqual(TEXT("NumMismatchedCells"), NumMismatchedCells, 0);
+			TestEqual(TEXT("GetMineGridMapVersion"), GameMode->GetMineGridMapVersion(), GivenVersion + 1);
+		});
+
+		It("should not send version revealing mines to player whose view is being set", [this]() {
+			// Prepare
+			*MaxDenseMapCellCountProperty->ContainerPtrToValuePtr<int32>(GameMode) = 0;
+			StartNewGame(1, 17, 0.3f);
+
+			auto Player = NewObject<AMinesweeperPlayerControllerBase>(World->PersistentLevel);
+			auto OtherPlayer = NewObject<AMinesweeperPlayerControllerBase>(World->PersistentLevel);
+			GameMode->SetPlayerViewBounds(OtherPlayer, FIntRect(FIntPoint(0, 0), FIntPoint(9, 7)));
+			IsGameOverProperty->SetPropertyValue_InContainer(GameMode, true);
+
+			const int32 GivenVersion = GameMode->GetMineGridMapVersion();
+			auto GetVersion = [this](AMinesweeperPlayerControllerBase* Controller) { return *GridMapAreaVersionProperty->ContainerPtrToValuePtr<int32>(Controller); };
+			const int32 GivenPlayerVersion = GetVersion(Player);
+
+			// Act
+			GameMode->SetPlayerViewBounds(Player, FIntRect(FIntPoint(2, 1), FIntPoint(6, 4)));
+
+			// Assert
+			TestEqual(TEXT("GetMineGridMapVersion"), GameMode->GetMineGridMapVersion(), GivenVersion + 1);
+			TestEqual(TEXT("Player version"), GetVersion(Player), GivenPlayerVersion);
+			TestEqual(TEXT("OtherPlayer version"), GetVersion(OtherPlayer), GivenVersion + 1);
+		});
+
+		It("should keep map of ongoing game unchanged", [this]() {
+			// Prepare
+			*MaxDenseMapCellCountProperty->ContainerPtrToValuePtr<int32>(GameMode) = 0;
+			StartNewGame(1, 17, 0.3f);
+
+			// Act
+			GameMode->SetPlayerViewBounds(nullptr, FIntRect(FIntPoint(0, 0), FIntPoint(9, 7)));
+
+			// Assert
+			TestEqual(TEXT("GetMineGridMapVersion"), GameMode->GetMineGridMapVersion(), 0);
+			TestEqual(TEXT("TileSlots.Num()"), GameMode->GetMineGridMap().TileSlots.Num(), 0);
+		});
+	});
+
+	AfterEach([this]() {
+		// Teardown
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	});
+}
@@ -11,11 +11,10 @@ BEGIN_DEFINE_SPEC(AMinesweeperPlayerControllerTest, "Minesweeper.MinesweeperPlay
 
 	FStructProperty* MineGridMapAreaProperty;
 	FStructProperty* PrevPlayerRelGridCoordsProperty;
-	FProperty* GridCellRefCountsProperty;
-	FProperty* GridCoordsCellsProperty;
 	FFloatProperty* CellSizeProperty;
 	FByteProperty* MapAreaMaxHalfSizeXProperty;
 	FByteProperty* MapAreaMaxHalfSizeYProperty;
+	FByteProperty* MapAreaEvictionMarginProperty;
 END_DEFINE_SPEC(AMinesweeperPlayerControllerTest)
 
 void AMinesweeperPlayerControllerTest::Define() 
@@ -53,14 +52,17 @@ void AMinesweeperPlayerControllerTest::Define()
 			auto Controller_MapAreaMaxHalfSizeYAddress = MapAreaMaxHalfSizeYProperty->ContainerPtrToValuePtr<uint8>(Controller);
 			*Controller_MapAreaMaxHalfSizeYAddress = 1;
 
+			// Cases below expect exact area around pawn
+			MapAreaEvictionMarginProperty = FindFieldChecked<FByteProperty>(Controller->GetClass(), TEXT("MapAreaEvictionMargin"));
+			auto Controller_MapAreaEvictionMarginAddress = MapAreaEvictionMarginProperty->ContainerPtrToValuePtr<uint8>(Controller);
+			*Controller_MapAreaEvictionMarginAddress = 0;
+
 			CellSizeProperty = FindFieldChecked<FFloatProperty>(MineGrid->GetClass(), TEXT("CellSize"));
 			auto MineGrid_CellSizeAddress = CellSizeProperty->ContainerPtrToValuePtr<float>(MineGrid);
 			*MineGrid_CellSizeAddress = 100.f;
 
 			MineGridMapAreaProperty = FindFieldChecked<FStructProperty>(Controller->GetClass(), TEXT("MineGridMapArea"));
 			PrevPlayerRelGridCoordsProperty = FindFieldChecked<FStructProperty>(Controller->GetClass(), TEXT("PrevPlayerRelativeGridCoords"));
-			GridCellRefCountsProperty = FindFieldChecked<FProperty>(MineGrid->GetClass(), TEXT("GridCellRefCounts"));
-			GridCoordsCellsProperty = FindFieldChecked<FProperty>(MineGrid->GetClass(), TEXT("GridCoordsCells"));
 		});
 
 		///
@@ -189,7 +191,9 @@ void AMinesweeperPlayerControllerTest::Define()
 				TestEqual(TEXT("MineGridMapArea.EndCoords"), MineGridMapArea.EndCoords, ExpectedAreaBounds.Max);
 				TestEqual(TEXT("MineGridMapArea.GridDimensions"), MineGridMapArea.GridDimensions, ExpectedAreaDimensions);
 
-				TestTrue(TEXT("MineGridMapArea.Cells.OrderIndependentCompareEqual(expected)"), MineGridMapArea.Cells.OrderIndependentCompareEqual(ExpectedAreaCells));
+				TMap<FIntPoint, EMineGridMapCell> MineGridMapAreaCells;
+				MineGridMapArea.ExportCells(MineGridMapAreaCells);
+				TestTrue(TEXT("MineGridMapAreaCells.OrderIndependentCompareEqual(expected)"), MineGridMapAreaCells.OrderIndependentCompareEqual(ExpectedAreaCells));
 			});
 		}
 
@@ -306,22 +310,22 @@ void AMinesweeperPlayerControllerTest::Define()
 					auto& MineGridMapArea = *MineGridMapAreaProperty->ContainerPtrToValuePtr<FMineGridMap>(Controller);
 					auto& MapAreaMaxHalfSizeX = *MapAreaMaxHalfSizeXProperty->ContainerPtrToValuePtr<uint8>(Controller);
 					auto& MapAreaMaxHalfSizeY = *MapAreaMaxHalfSizeYProperty->ContainerPtrToValuePtr<uint8>(Controller);
-					auto& GridCellRefCounts = *GridCellRefCountsProperty->ContainerPtrToValuePtr<TMap<FIntPoint, uint8>>(MineGrid);
-					auto& GridCoordsCells = *GridCoordsCellsProperty->ContainerPtrToValuePtr<TMap<FIntPoint, void*>>(MineGrid);
 					MineGridMapArea.StartCoords.X = FMath::Clamp(PrevPlayerRelGridCoords.X - MapAreaMaxHalfSizeX, GivenGridMap.StartCoords.X, GivenGridMap.EndCoords.X);
 					MineGridMapArea.StartCoords.Y = FMath::Clamp(PrevPlayerRelGridCoords.Y - MapAreaMaxHalfSizeY, GivenGridMap.StartCoords.Y, GivenGridMap.EndCoords.Y);
 					MineGridMapArea.EndCoords.X = FMath::Clamp(PrevPlayerRelGridCoords.X + MapAreaMaxHalfSizeX, GivenGridMap.StartCoords.X, GivenGridMap.EndCoords.X);
 					MineGridMapArea.EndCoords.Y = FMath::Clamp(PrevPlayerRelGridCoords.Y + MapAreaMaxHalfSizeY, GivenGridMap.StartCoords.Y, GivenGridMap.EndCoords.Y);
 					MineGridMapArea.GridDimensions = MineGridMapArea.EndCoords - MineGridMapArea.StartCoords + 1;
-					MineGridMapArea.Cells.Reserve(MineGridMapArea.GridDimensions.X * MineGridMapArea.GridDimensions.Y);
-					GridCellRefCounts.Reserve(MineGridMapArea.GridDimensions.X * MineGridMapArea.GridDimensions.Y);
+					MineGridMapArea.ReserveWindow(MineGridMapArea.GridDimensions);
+					FMineGridMapChanges GridCellsChanges;
+					GridCellsChanges.NewGridDimensions = MineGridMapArea.GridDimensions;
 					for (int32 Y = MineGridMapArea.StartCoords.Y; Y <= MineGridMapArea.EndCoords.Y; Y++) {
 						for (int32 X = MineGridMapArea.StartCoords.X; X <= MineGridMapArea.EndCoords.X; X++) {
-							MineGridMapArea.Cells.Emplace(FIntPoint(X, Y), GivenGridMap.Cells[FIntPoint(X, Y)]);
-							GridCellRefCounts.Emplace(FIntPoint(X, Y), 1);
-							GridCoordsCells.Emplace(FIntPoint(X, Y), nullptr);
+							MineGridMapArea.SetCell(FIntPoint(X, Y), GivenGridMap.Cells[FIntPoint(X, Y)]);
+							GridCellsChanges.AddedGridMapCellCoords.Emplace(X, Y);
+							GridCellsChanges.AddedGridMapCellValues.Emplace(GivenGridMap.Cells[FIntPoint(X, Y)]);
 						}
 					}
+					MineGrid->AddOrRemoveGridCells(GridCellsChanges);
 
 					auto ExpectedAreaDimensions = ExpectedAreaBounds.Size() + 1;
 					auto ExpectedAreaCells = TMap<FIntPoint, EMineGridMapCell>();
@@ -340,12 +344,129 @@ void AMinesweeperPlayerControllerTest::Define()
 					TestEqual(TEXT("MineGridMapArea.EndCoords"), MineGridMapArea.EndCoords, ExpectedAreaBounds.Max);
 					TestEqual(TEXT("MineGridMapArea.GridDimensions"), MineGridMapArea.GridDimensions, ExpectedAreaDimensions);
 
-					TestTrue(TEXT("MineGridMapArea.Cells.OrderIndependentCompareEqual(expected)"), MineGridMapArea.Cells.OrderIndependentCompareEqual(ExpectedAreaCells));
+					TMap<FIntPoint, EMineGridMapCell> MineGridMapAreaCells;
+					MineGridMapArea.ExportCells(MineGridMapAreaCells);
+					TestTrue(TEXT("MineGridMapAreaCells.OrderIndependentCompareEqual(expected)"), MineGridMapAreaCells.OrderIndependentCompareEqual(ExpectedAreaCells));
 				});
 			}
 		});
 
-		
+
+		///
+		/// Moving back and forth with eviction margin
+		///
+		It("should keep cells within eviction margin: moving back and forth", [this]() {
+			// Prepare
+			*MapAreaEvictionMarginProperty->ContainerPtrToValuePtr<uint8>(Controller) = 1;
+
+			auto& MineGridMapArea = *MineGridMapAreaProperty->ContainerPtrToValuePtr<FMineGridMap>(Controller);
+			auto& CellSize = *CellSizeProperty->ContainerPtrToValuePtr<float>(MineGrid);
+
+			GivenGridMap.GridDimensions = FIntPoint(11, 5);
+			GivenGridMap.StartCoords = FIntPoint::ZeroValue;
+			GivenGridMap.EndCoords = GivenGridMap.GridDimensions - 1;
+			for (int32 Y = GivenGridMap.StartCoords.Y; Y <= GivenGridMap.EndCoords.Y; Y++) {
+				for (int32 X = GivenGridMap.StartCoords.X; X <= GivenGridMap.EndCoords.X; X++) {
+					GivenGridMap.Cells.Emplace(FIntPoint(X, Y), (EMineGridMapCell)FMath::RandRange(0, 8));
+				}
+			}
+
+			Pawn->SetActorLocation(FVector(5, 2, 0) * CellSize);
+			Controller->AddRemoveGridMapAreaCells(GivenGridMap, true);
+
+			// Act
+			Pawn->SetActorLocation(FVector(6, 2, 0) * CellSize);
+			Controller->AddRemoveGridMapAreaCells(GivenGridMap, false);
+
+			Pawn->SetActorLocation(FVector(5, 2, 0) * CellSize);
+			Controller->AddRemoveGridMapAreaCells(GivenGridMap, false);
+
+			// Assert
+			//  □□□□□□□□□□□
+			//  □□□■■■■■■□□
+			//  □□□■■◊■■■□□
+			//  □□□■■■■■■□□
+			//  □□□□□□□□□□□
+			TestEqual(TEXT("MineGridMapArea.StartCoords"), MineGridMapArea.StartCoords, FIntPoint(3, 1));
+			TestEqual(TEXT("MineGridMapArea.EndCoords"), MineGridMapArea.EndCoords, FIntPoint(8, 3));
+
+			TMap<FIntPoint, EMineGridMapCell> MineGridMapAreaCells;
+			MineGridMapArea.ExportCells(MineGridMapAreaCells);
+			TestEqual(TEXT("MineGridMapAreaCells.Num()"), MineGridMapAreaCells.Num(), 6 * 3);
+		});
+
+		AfterEach([this]() {
+			// Teardown
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		});
+	});
+
+	Describe("OnRep_MapAreaBounds", [this]() {
+		BeforeEach([this]() {
+			// Setup
+			World = UWorld::CreateWorld(EWorldType::Game, false);
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+
+			FURL URL;
+			World->InitializeActorsForPlay(URL);
+			World->BeginPlay();
+
+			Controller = NewObject<AMinesweeperPlayerControllerBase>(World->PersistentLevel);
+
+			MineGridMapAreaProperty = FindFieldChecked<FStructProperty>(Controller->GetClass(), TEXT("MineGridMapArea"));
+		});
+
+		It("should show cells replicated along with new bounds once bounds are applied", [this]() {
+			// Prepare
+			auto& MineGridMapArea = *MineGridMapAreaProperty->ContainerPtrToValuePtr<FMineGridMap>(Controller);
+			auto& MapAreaCells = *FindFieldChecked<FStructProperty>(Controller->GetClass(), TEXT("MapAreaCells"))->ContainerPtrToValuePtr<FMineGridMapAreaCells>(Controller);
+			auto& MapAreaBounds = *FindFieldChecked<FStructProperty>(Controller->GetClass(), TEXT("MapAreaBounds"))->ContainerPtrToValuePtr<FMineGridMapAreaBounds>(Controller);
+			UFunction* OnRepMapAreaBounds = Controller->FindFunctionChecked(TEXT("OnRep_MapAreaBounds"));
+
+			// Replicate area of three cells, followed by its bounds as engine calls rep notifies after fast array callbacks
+			FMineGridMapAreaBounds OldMapAreaBounds = MapAreaBounds;
+			MapAreaBounds.StartCoords = FIntPoint(0, 0);
+			MapAreaBounds.EndCoords = FIntPoint(2, 0);
+
+			TArray<int32> AddedIndices;
+			for (int32 X = 0; X <= 2; X++)
+			{
+				FMineGridMapAreaCell& Item = MapAreaCells.Items.AddDefaulted_GetRef();
+				Item.Coords = FIntPoint(X, 0);
+				Item.Value = EMineGridMapCell::MGMC_Zero;
+				AddedIndices.Add(MapAreaCells.Items.Num() - 1);
+			}
+			MapAreaCells.PostReplicatedAdd(AddedIndices, MapAreaCells.Items.Num());
+			Controller->ProcessEvent(OnRepMapAreaBounds, &OldMapAreaBounds);
+
+			// Act, area moving right by one cell, cell entering it being replicated in the same update
+			OldMapAreaBounds = MapAreaBounds;
+			MapAreaBounds.StartCoords = FIntPoint(1, 0);
+			MapAreaBounds.EndCoords = FIntPoint(3, 0);
+
+			FMineGridMapAreaCell& EnteringItem = MapAreaCells.Items.AddDefaulted_GetRef();
+			EnteringItem.Coords = FIntPoint(3, 0);
+			EnteringItem.Value = EMineGridMapCell::MGMC_Two;
+			AddedIndices = { MapAreaCells.Items.Num() - 1 };
+
+			MapAreaCells.PostReplicatedAdd(AddedIndices, MapAreaCells.Items.Num());
+			const bool bIsEnteringCellShownBeforeBounds = MineGridMapArea.HasCell(FIntPoint(3, 0));
+
+			Controller->ProcessEvent(OnRepMapAreaBounds, &OldMapAreaBounds);
+
+			// Assert
+			TestFalse(TEXT("bIsEnteringCellShownBeforeBounds"), bIsEnteringCellShownBeforeBounds);
+			TestEqual(TEXT("MineGridMapArea.StartCoords"), MineGridMapArea.StartCoords, FIntPoint(1, 0));
+			TestEqual(TEXT("MineGridMapArea.EndCoords"), MineGridMapArea.EndCoords, FIntPoint(3, 0));
+
+			TMap<FIntPoint, EMineGridMapCell> MineGridMapAreaCells;
+			MineGridMapArea.ExportCells(MineGridMapAreaCells);
+			TestEqual(TEXT("MineGridMapAreaCells.Num()"), MineGridMapAreaCells.Num(), 3);
+			TestFalse(TEXT("MineGridMapAreaCells.Contains(0, 0)"), MineGridMapAreaCells.Contains(FIntPoint(0, 0)));
+			TestTrue(TEXT("MineGridMapAreaCells[3, 0] == MGMC_Two"), MineGridMapAreaCells.FindRef(FIntPoint(3, 0)) == EMineGridMapCell::MGMC_Two);
+		});
 
 		AfterEach([this]() {
 			// Teardown